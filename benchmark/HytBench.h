@@ -0,0 +1,191 @@
+//
+//
+// Helpers shared by the benchmarks: parse the generated IR, run a pass of
+// this repo on it quietly, read back the JSON line the pass reported, and
+// run each case in a process of its own.
+//
+
+#ifndef HYT_BENCH_H
+#define HYT_BENCH_H
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Pass.h"
+#include "llvm/PassInfo.h"
+#include "llvm/PassRegistry.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#ifdef LLVM_ON_UNIX
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace hytbench {
+  using namespace llvm;
+
+  // Parses the generated module `name`, and also writes it to
+  // <emitDir>/<name>.ll when emitDir is set. Returns nullptr on errors.
+  inline std::unique_ptr<Module> ParseGenerated(const std::string &IR, const std::string &name,
+                                                StringRef emitDir, LLVMContext &Context) {
+    if(!emitDir.empty()) {
+      SmallString<128> path(emitDir);
+      sys::path::append(path, name + ".ll");
+      std::error_code EC;
+      raw_fd_ostream OS(path, EC, sys::fs::OF_Text);
+      if(EC) {
+        errs() << "[ERROR] Cannot write " << path << ": " << EC.message() << "\n";
+        return nullptr;
+      }
+      OS << IR;
+    }
+
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(IR, Err, Context);
+    if(!M) {
+      Err.print(name.c_str(), errs());
+      return nullptr;
+    }
+    M->setModuleIdentifier(name);
+    if(verifyModule(*M, &errs())) {
+      errs() << "[ERROR] Generated module " << name << " is broken.\n";
+      return nullptr;
+    }
+    return M;
+  }
+
+  // Runs the registered pass `arg` on M and returns the wall-clock seconds it
+  // took, or -1 if no such pass is linked in. The passes print their
+  // warnings to stderr, so stderr goes to /dev/null unless `verbose`.
+  inline double RunPass(StringRef arg, Module &M, bool verbose) {
+    const PassInfo *PI = PassRegistry::getPassRegistry()->getPassInfo(arg);
+    if(!PI) {
+      errs() << "[ERROR] " << arg << " is not registered.\n";
+      return -1;
+    }
+
+#ifdef LLVM_ON_UNIX
+    int savedErr = -1;
+    if(!verbose) {
+      errs().flush();
+      savedErr = dup(2);
+      int null = open("/dev/null", O_WRONLY);
+      dup2(null, 2);
+      close(null);
+    }
+#endif
+
+    auto start = std::chrono::steady_clock::now();
+    legacy::PassManager PM;
+    PM.add(PI->createPass());
+    PM.run(M);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+#ifdef LLVM_ON_UNIX
+    if(savedErr >= 0) {
+      errs().flush();
+      dup2(savedErr, 2);
+      close(savedErr);
+    }
+#endif
+    return seconds;
+  }
+
+  // The last line of the JSON lines file `path` that `match` accepts.
+  inline json::Value LastReport(StringRef path, function_ref<bool(const json::Object &)> match) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> buf = MemoryBuffer::getFile(path);
+    if(!buf) {
+      return nullptr;
+    }
+    SmallVector<StringRef, 16> lines;
+    (*buf)->getBuffer().split(lines, '\n', -1, false);
+    for(auto it = lines.rbegin(); it != lines.rend(); ++it) {
+      Expected<json::Value> v = json::parse(*it);
+      if(!v) {
+        consumeError(v.takeError());
+        continue;
+      }
+      const json::Object *obj = v->getAsObject();
+      if(obj && match(*obj)) {
+        return std::move(*v);
+      }
+    }
+    return nullptr;
+  }
+
+  // `key` of a report as CSV text, empty if the report does not have it.
+  inline std::string ReportField(const json::Value &report, StringRef key) {
+    const json::Object *obj = report.getAsObject();
+    const json::Value *v = obj ? obj->get(key) : nullptr;
+    if(!v) {
+      return "";
+    }
+    std::string s;
+    raw_string_ostream OS(s);
+    OS << *v;
+    return OS.str();
+  }
+
+  // A cl::opt of a pass linked into the benchmark, e.g. its report file.
+  template <typename T> cl::opt<T> *PassOption(StringRef name) {
+    return static_cast<cl::opt<T> *>(cl::getRegisteredOptions().lookup(name));
+  }
+
+  // Unless `verbose` or -hyt-results is given, the passes write no results,
+  // so the timings do not include formatting them.
+  inline void QuietResults(bool verbose) {
+    cl::Option *O = cl::getRegisteredOptions().lookup("hyt-results");
+    if(!verbose && O && O->getNumOccurrences() == 0) {
+      O->addOccurrence(0, "hyt-results", "off");
+    }
+  }
+
+  enum CaseResult { CaseOK, CaseFailed, CaseTimedOut };
+
+  // Runs one case in a child process, so its peak RSS is its own and a crash
+  // or a case over `timeout` seconds (0: none) does not stop the others.
+  inline CaseResult RunIsolated(function_ref<int()> fn, unsigned timeout) {
+#ifdef LLVM_ON_UNIX
+    outs().flush();
+    errs().flush();
+    pid_t pid = fork();
+    if(pid == 0) {
+      if(timeout) {
+        alarm(timeout);
+      }
+      int ret = fn();
+      outs().flush();
+      errs().flush();
+      _exit(ret & 0xff);
+    }
+    int status = 0;
+    if(pid < 0 || waitpid(pid, &status, 0) < 0) {
+      return CaseFailed;
+    }
+    if(WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM) {
+      return CaseTimedOut;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? CaseOK : CaseFailed;
+#else
+    return fn() == 0 ? CaseOK : CaseFailed;
+#endif
+  }
+}
+
+#endif
@@ -0,0 +1,305 @@
+//
+//
+// Data Flow Analysis benchmark
+//
+// Generates one function per input (deep loop nests, irreducible CFGs, huge
+// switches, long straight-line code) with a given number of statements, runs
+// Reaching Definition, Live Variables and Available Expressions on it, one
+// by one and fused in one solver, and prints one CSV row per input and
+// analysis. The full solver statistics of every run are appended to the
+// -hyt-{rd,lva,aea,fused}-report file.
+//
+
+
+#include "HytBench.h"
+
+#include "llvm/InitializePasses.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+using namespace llvm;
+
+static cl::list<string> Analyses(
+    "analysis", cl::CommaSeparated,
+    cl::desc("Analyses to run: rd, lva, aea, fused (default: all)"));
+
+static cl::list<string> Shapes(
+    "shape", cl::CommaSeparated,
+    cl::desc("Inputs to generate: straight, loops, irreducible, switch (default: all)"));
+
+static cl::list<unsigned> Scales(
+    "scale", cl::CommaSeparated,
+    cl::desc("Statements per input, one definition and one expression each (default: 1000,10000,100000,1000000)"));
+
+static cl::opt<unsigned> BlockSize(
+    "block-size", cl::init(16),
+    cl::desc("Statements per basic block"));
+
+static cl::opt<unsigned> Depth(
+    "depth", cl::init(16),
+    cl::desc("Nesting depth of the loops shape"));
+
+static cl::opt<unsigned> Vars(
+    "vars", cl::init(0),
+    cl::desc("Local variables of each input (0: a quarter of the statements, at least 16)"));
+
+static cl::opt<unsigned> CaseTimeout(
+    "case-timeout", cl::value_desc("seconds"), cl::init(600),
+    cl::desc("Stop a case after <seconds> (0: never)"));
+
+static cl::opt<string> Output(
+    "o", cl::value_desc("file"), cl::init("hyt-dfa-bench.jsonl"),
+    cl::desc("Report file the passes append their statistics to"));
+
+static cl::opt<string> EmitDir(
+    "emit-dir", cl::init(""),
+    cl::desc("Also write every generated input as <dir>/<shape>-<scale>.ll"));
+
+static cl::opt<bool> Verbose(
+    "verbose", cl::init(false),
+    cl::desc("Keep the output of the passes"));
+
+namespace {
+  struct Analysis {
+    const char *name;   // -analysis value, also "analysis" of the report.
+    const char *pass;   // Registered pass argument.
+    const char *report; // Report option of the pass.
+  };
+
+  const Analysis kAnalyses[] = {
+    {"rd", "hytDFA_ReachingDefinition", "hyt-rd-report"},
+    {"lva", "hytDFA_LiveVariables", "hyt-lva-report"},
+    {"aea", "hytDFA_AvailableExpresions", "hyt-aea-report"},
+    {"fused", "hytDFA_Fused", "hyt-fused-report"},
+  };
+
+  // Writes `void @bench(i32 %n)` in the shape of clang -O0 output: every
+  // variable is an alloca, and statement k is `vD = vA op vB` through loads
+  // and a store. Statements are spread over blocks of -block-size.
+  class IRGen {
+  public:
+    IRGen(const string &shape, unsigned statements)
+      : shape_(shape), statements_(statements), OS_(IR_),
+        vars_(Vars ? Vars : std::max<unsigned>(statements / 4, 16)),
+        blocks_(std::max<unsigned>((statements + std::max<unsigned>(BlockSize, 1) - 1) /
+                                   std::max<unsigned>(BlockSize, 1), 2)) {}
+
+    string Generate() {
+      OS_ << "define dso_local void @bench(i32 %n) {\n"
+          << "entry:\n";
+      for(unsigned i = 0; i < vars_; i++) {
+        OS_ << "  %v" << i << " = alloca i32, align 4\n";
+      }
+      OS_ << "  %cnt = alloca i32, align 4\n"
+          << "  store i32 %n, i32* %cnt, align 4\n";
+
+      if(shape_ == "straight") { // entry -> b0 -> b1 -> ... -> ret.
+        OS_ << "  br label %b0\n";
+        for(unsigned b = 0; b < blocks_; b++) {
+          Block(b, b + 1 < blocks_ ? "br label %b" + std::to_string(b + 1) : "ret void");
+        }
+      } else if(shape_ == "loops") { // h0 { h1 { ... { b0 .. bn } } }, each hk leaves to xk.
+        unsigned depth = std::max<unsigned>(Depth, 1);
+        OS_ << "  br label %h0\n";
+        for(unsigned k = 0; k < depth; k++) {
+          OS_ << "h" << k << ":\n";
+          Branch(k + 1 < depth ? "h" + std::to_string(k + 1) : "b0", "x" + std::to_string(k));
+        }
+        for(unsigned b = 0; b < blocks_; b++) {
+          Block(b, "br label %" + (b + 1 < blocks_ ? "b" + std::to_string(b + 1) : "h" + std::to_string(depth - 1)));
+        }
+        for(unsigned k = depth; k-- > 0;) {
+          OS_ << "x" << k << ":\n"
+              << "  " << (k ? "br label %h" + std::to_string(k - 1) : "ret void") << "\n";
+        }
+      } else if(shape_ == "irreducible") { // A ring b0 -> ... -> bn -> b0 entered at b0 and at bn/2.
+        string c = Cond();
+        OS_ << "  br i1 " << c << ", label %b0, label %b" << blocks_ / 2 << "\n";
+        for(unsigned b = 0; b < blocks_; b++) {
+          BlockWithBranch(b, "b" + std::to_string((b + 1) % blocks_), "exit");
+        }
+        OS_ << "exit:\n  ret void\n";
+      } else { // switch: a loop around one switch with a case per block.
+        OS_ << "  br label %head\n"
+            << "head:\n";
+        string s = Tmp();
+        OS_ << "  " << s << " = load i32, i32* %cnt, align 4\n"
+            << "  switch i32 " << s << ", label %latch [\n";
+        for(unsigned b = 0; b < blocks_; b++) {
+          OS_ << "    i32 " << b << ", label %b" << b << "\n";
+        }
+        OS_ << "  ]\n";
+        for(unsigned b = 0; b < blocks_; b++) {
+          Block(b, "br label %latch");
+        }
+        OS_ << "latch:\n";
+        Branch("head", "exit");
+        OS_ << "exit:\n  ret void\n";
+      }
+      OS_ << "}\n";
+      return OS_.str();
+    }
+
+  private:
+    string Tmp() { return "%t" + std::to_string(tmp_++); }
+
+    // vD = vA op vB; with A, B and D spread over all variables.
+    void Statement(unsigned k) {
+      static const char *const ops[] = {"add nsw", "sub nsw", "mul nsw", "xor"};
+      string a = Tmp(), b = Tmp(), r = Tmp();
+      OS_ << "  " << a << " = load i32, i32* %v" << k % vars_ << ", align 4\n"
+          << "  " << b << " = load i32, i32* %v" << (k * 7 + 3) % vars_ << ", align 4\n"
+          << "  " << r << " = " << ops[k % 4] << " i32 " << a << ", " << b << "\n"
+          << "  store i32 " << r << ", i32* %v" << (k * 13 + 5) % vars_ << ", align 4\n";
+    }
+
+    // The statements of block b, which is the b-th share of all statements.
+    void Statements(unsigned b) {
+      unsigned per = std::max<unsigned>(BlockSize, 1);
+      for(unsigned k = b * per; k < std::min(statements_, (b + 1) * per); k++) {
+        Statement(k);
+      }
+    }
+
+    string Cond() {
+      string c = Tmp(), t = Tmp();
+      OS_ << "  " << c << " = load i32, i32* %cnt, align 4\n"
+          << "  " << t << " = icmp sgt i32 " << c << ", 0\n";
+      return t;
+    }
+
+    void Branch(const string &then, const string &otherwise) {
+      string t = Cond();
+      OS_ << "  br i1 " << t << ", label %" << then << ", label %" << otherwise << "\n";
+    }
+
+    void Block(unsigned b, const string &terminator) {
+      OS_ << "b" << b << ":\n";
+      Statements(b);
+      OS_ << "  " << terminator << "\n";
+    }
+
+    void BlockWithBranch(unsigned b, const string &then, const string &otherwise) {
+      OS_ << "b" << b << ":\n";
+      Statements(b);
+      Branch(then, otherwise);
+    }
+
+    string shape_;
+    unsigned statements_;
+    string IR_;
+    raw_string_ostream OS_;
+    unsigned vars_;
+    unsigned blocks_;
+    unsigned tmp_ = 0;
+  };
+
+  // Generates, parses and analyzes one input. Returns the exit code of the case.
+  int RunCase(const Analysis &A, const string &shape, unsigned statements) {
+    string name = shape + "-" + std::to_string(statements);
+
+    auto start = std::chrono::steady_clock::now();
+    string IR = IRGen(shape, statements).Generate();
+    LLVMContext Context;
+    std::unique_ptr<Module> M = hytbench::ParseGenerated(IR, name, EmitDir, Context);
+    if(!M) {
+      return -1;
+    }
+    double genSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double runSeconds = hytbench::RunPass(A.pass, *M, Verbose);
+    if(runSeconds < 0) {
+      return -1;
+    }
+
+    json::Value r = hytbench::LastReport(Output, [&](const json::Object &obj) {
+      return obj.getString("module") == StringRef(name) && obj.getString("analysis") == StringRef(A.name);
+    });
+    outs() << A.name << "," << shape << "," << statements << ","
+           << format("%.3f", genSeconds) << "," << format("%.3f", runSeconds);
+    for(const char *key : {"facts", "blocks", "rounds", "block_visits", "init_seconds",
+                           "solve_seconds", "peak_rss_kb"}) {
+      outs() << "," << hytbench::ReportField(r, key);
+    }
+    outs() << "\n";
+    outs().flush();
+    return 0;
+  }
+}
+
+int main(int argc, char **argv) {
+  PassRegistry &Registry = *PassRegistry::getPassRegistry();
+  initializeCore(Registry);
+  initializeAnalysis(Registry);
+
+  cl::ParseCommandLineOptions(argc, argv, "Hyt data flow analysis benchmark\n");
+
+  vector<const Analysis *> analyses;
+  for(const Analysis &A : kAnalyses) {
+    if(Analyses.empty() || llvm::is_contained(Analyses, A.name)) {
+      analyses.push_back(&A);
+    }
+  }
+  for(const string &name : Analyses) {
+    if(name != "rd" && name != "lva" && name != "aea" && name != "fused") {
+      errs() << "[ERROR] Unknown analysis: " << name << "\n";
+      return -1;
+    }
+  }
+  // The statistics come from the passes themselves, written with -hyt-*-report.
+  for(const Analysis *A : analyses) {
+    cl::opt<string> *Report = hytbench::PassOption<string>(A->report);
+    if(!Report) {
+      errs() << "[ERROR] " << A->pass << " is not linked in.\n";
+      return -1;
+    }
+    Report->setValue(Output);
+  }
+  hytbench::QuietResults(Verbose);
+
+  vector<string> shapes(Shapes.begin(), Shapes.end());
+  if(shapes.empty()) {
+    shapes = {"straight", "loops", "irreducible", "switch"};
+  }
+  for(const string &shape : shapes) {
+    if(shape != "straight" && shape != "loops" && shape != "irreducible" && shape != "switch") {
+      errs() << "[ERROR] Unknown shape: " << shape << "\n";
+      return -1;
+    }
+  }
+  vector<unsigned> scales(Scales.begin(), Scales.end());
+  if(scales.empty()) {
+    scales = {1000, 10000, 100000, 1000000};
+  }
+
+  outs() << "analysis,shape,statements,generate_seconds,run_seconds,facts,blocks,rounds,block_visits,"
+         << "init_seconds,solve_seconds,peak_rss_kb\n";
+  outs().flush();
+
+  int ret = 0;
+  for(const string &shape : shapes) {
+    for(unsigned statements : scales) {
+      for(const Analysis *A : analyses) {
+        hytbench::CaseResult result = hytbench::RunIsolated([&] {
+          return RunCase(*A, shape, statements);
+        }, CaseTimeout);
+        if(result == hytbench::CaseTimedOut) { // Keep the row, so slow cases show up in the table.
+          outs() << A->name << "," << shape << "," << statements << ",,timeout\n";
+          outs().flush();
+        } else if(result != hytbench::CaseOK) {
+          errs() << "[ERROR] Case " << A->name << " " << shape << "-" << statements << " failed.\n";
+          ret = -1;
+        }
+      }
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,404 @@
+//
+//
+// Pointer Analysis benchmark
+//
+// Generates C++-shaped IR (class hierarchies, virtual calls, copy chains,
+// PFG cycles, field loads/stores) at a given number of statements, runs
+// hytDFA_PointerAnalysis on it and prints one CSV row per input. The full
+// solver statistics of every run are appended to the -hyt-pta-report file.
+//
+
+
+#include "HytBench.h"
+
+#include "llvm/InitializePasses.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+using namespace llvm;
+
+static cl::list<string> Shapes(
+    "shape", cl::CommaSeparated,
+    cl::desc("Inputs to generate: hierarchy, dispatch, copies, cycles, fields, mixed (default: all)"));
+
+static cl::list<unsigned> Scales(
+    "scale", cl::CommaSeparated,
+    cl::desc("Statements per input (default: 1000,10000,100000,1000000)"));
+
+static cl::opt<unsigned> Chunk(
+    "chunk", cl::init(1000),
+    cl::desc("Statements per generated method"));
+
+static cl::opt<unsigned> Depth(
+    "depth", cl::init(16),
+    cl::desc("Length of the class chain of the hierarchy shape"));
+
+static cl::opt<unsigned> Width(
+    "width", cl::init(64),
+    cl::desc("Number of sibling classes of the dispatch shape"));
+
+static cl::opt<unsigned> Chain(
+    "chain", cl::init(64),
+    cl::desc("Length of the copy chains and PFG cycles"));
+
+static cl::opt<unsigned> Vars(
+    "vars", cl::init(256),
+    cl::desc("Local variables of each generated method (at least -chain)"));
+
+static cl::opt<string> EmitDir(
+    "emit-dir", cl::init(""),
+    cl::desc("Also write every generated input as <dir>/<shape>-<scale>.ll"));
+
+static cl::opt<unsigned> CaseBudget(
+    "case-budget", cl::value_desc("seconds"), cl::init(600),
+    cl::desc("-hyt-pta-time-budget of each case when none is given (0: none)"));
+
+static cl::opt<bool> Verbose(
+    "verbose", cl::init(false),
+    cl::desc("Keep the output of the pass"));
+
+namespace {
+  // Itanium names, so the vtable parser of the pass sees what clang emits.
+  string Nested(const string &cls, const string &method) {
+    return "_ZN" + std::to_string(cls.size()) + cls + method + "Ev";
+  }
+
+  string Ctor(const string &cls) {
+    return "_ZN" + std::to_string(cls.size()) + cls + "C2Ev";
+  }
+
+  string VTable(const string &cls) {
+    return "_ZTV" + std::to_string(cls.size()) + cls;
+  }
+
+  string TypeInfo(const string &cls) {
+    return "_ZTI" + std::to_string(cls.size()) + cls;
+  }
+
+  // Writes one module. Every class has a vtable with a single virtual `foo`.
+  // The statements are spread over methods of `Driver`, which main calls on
+  // one Driver object, so they become reachable like any other method.
+  class IRGen {
+  public:
+    IRGen(const string &shape, unsigned statements)
+      : shape_(shape), statements_(statements), OS_(IR_),
+        vars_(std::max<unsigned>(std::max<unsigned>(Vars, Chain), 2)) {}
+
+    string Generate() {
+      vector<string> parents;
+      for(unsigned i = 0; i < Depth; i++) { // C0 <- C1 <- ... <- Cd-1.
+        classes_.push_back("C" + std::to_string(i));
+        parents.push_back(i ? classes_[i - 1] : "");
+      }
+      for(unsigned i = 0; i < Width; i++) { // W0..Ww-1, all derived from C0.
+        classes_.push_back("W" + std::to_string(i));
+        parents.push_back("C0");
+      }
+
+      for(size_t i = 0; i < classes_.size(); i++) {
+        if(parents[i].empty()) {
+          OS_ << "%class." << classes_[i] << " = type { i32 (...)** }\n";
+        } else {
+          OS_ << "%class." << classes_[i] << " = type { %class." << parents[i] << " }\n";
+        }
+      }
+      OS_ << "%class.Box = type { i32, %class.C0* }\n";
+      OS_ << "%class.Driver = type { i8 }\n\n";
+
+      for(const string &cls : classes_) { // The pass finds the slots after the typeinfo bitcast.
+        OS_ << "@" << TypeInfo(cls) << " = external dso_local constant { i8*, i8* }\n"
+            << "@" << VTable(cls) << " = linkonce_odr dso_local unnamed_addr constant { [3 x i8*] } "
+            << "{ [3 x i8*] [i8* null, i8* bitcast ({ i8*, i8* }* @" << TypeInfo(cls)
+            << " to i8*), i8* bitcast (void (%class." << cls << "*)* @" << Nested(cls, "3foo") << " to i8*)] }, align 8\n";
+      }
+      OS_ << "\ndeclare dso_local nonnull i8* @_Znwm(i64)\n\n";
+
+      for(size_t i = 0; i < classes_.size(); i++) {
+        EmitClassMethods(classes_[i], parents[i]);
+      }
+
+      unsigned methods = 0;
+      for(unsigned done = 0; done < statements_; methods++) {
+        unsigned n = std::min<unsigned>(std::max<unsigned>(Chunk, 1), statements_ - done);
+        EmitDriverMethod(methods, n);
+        done += n;
+      }
+      EmitMain(methods);
+      return OS_.str();
+    }
+
+  private:
+    void EmitClassMethods(const string &cls, const string &parent) {
+      string ty = "%class." + cls;
+      OS_ << "define linkonce_odr dso_local void @" << Ctor(cls) << "(" << ty << "* %this) unnamed_addr align 2 {\n"
+          << "entry:\n"
+          << "  %this.addr = alloca " << ty << "*, align 8\n"
+          << "  store " << ty << "* %this, " << ty << "** %this.addr, align 8\n"
+          << "  %this1 = load " << ty << "*, " << ty << "** %this.addr, align 8\n";
+      if(!parent.empty()) {
+        OS_ << "  %base = bitcast " << ty << "* %this1 to %class." << parent << "*\n"
+            << "  call void @" << Ctor(parent) << "(%class." << parent << "* %base)\n";
+      }
+      OS_ << "  %vptr = bitcast " << ty << "* %this1 to i32 (...)***\n"
+          << "  store i32 (...)** bitcast (i8** getelementptr inbounds ({ [3 x i8*] }, { [3 x i8*] }* @"
+          << VTable(cls) << ", i32 0, inrange i32 0, i32 2) to i32 (...)**), i32 (...)*** %vptr, align 8\n"
+          << "  ret void\n}\n\n";
+
+      OS_ << "define linkonce_odr dso_local void @" << Nested(cls, "3foo") << "(" << ty << "* %this) unnamed_addr align 2 {\n"
+          << "entry:\n"
+          << "  %this.addr = alloca " << ty << "*, align 8\n"
+          << "  store " << ty << "* %this, " << ty << "** %this.addr, align 8\n"
+          << "  %this1 = load " << ty << "*, " << ty << "** %this.addr, align 8\n"
+          << "  ret void\n}\n\n";
+    }
+
+    string Tmp() { return "%t" + std::to_string(tmp_++); }
+
+    string Var(unsigned i) { return "%v" + std::to_string(i % vars_); }
+
+    // x = new cls(); The object is stored as a C0*, like `Base *x = new Derived()`.
+    void New(const string &x, const string &cls) {
+      string call = Tmp(), obj = Tmp();
+      OS_ << "  " << call << " = call noalias nonnull i8* @_Znwm(i64 8)\n"
+          << "  " << obj << " = bitcast i8* " << call << " to %class." << cls << "*\n"
+          << "  call void @" << Ctor(cls) << "(%class." << cls << "* " << obj << ")\n";
+      if(cls != "C0") {
+        string up = Tmp();
+        OS_ << "  " << up << " = bitcast %class." << cls << "* " << obj << " to %class.C0*\n";
+        obj = up;
+      }
+      OS_ << "  store %class.C0* " << obj << ", %class.C0** " << x << ", align 8\n";
+    }
+
+    // x = y;
+    void Copy(const string &x, const string &y) {
+      string v = Tmp();
+      OS_ << "  " << v << " = load %class.C0*, %class.C0** " << y << ", align 8\n"
+          << "  store %class.C0* " << v << ", %class.C0** " << x << ", align 8\n";
+    }
+
+    // x->foo();
+    void VirtualCall(const string &x) {
+      string p = Tmp(), vp = Tmp(), vt = Tmp(), fp = Tmp(), fn = Tmp();
+      OS_ << "  " << p << " = load %class.C0*, %class.C0** " << x << ", align 8\n"
+          << "  " << vp << " = bitcast %class.C0* " << p << " to void (%class.C0*)***\n"
+          << "  " << vt << " = load void (%class.C0*)**, void (%class.C0*)*** " << vp << ", align 8\n"
+          << "  " << fp << " = getelementptr inbounds void (%class.C0*)*, void (%class.C0*)** " << vt << ", i64 0\n"
+          << "  " << fn << " = load void (%class.C0*)*, void (%class.C0*)** " << fp << ", align 8\n"
+          << "  call void " << fn << "(%class.C0* " << p << ")\n";
+    }
+
+    // b = new Box();
+    void NewBox(const string &b) {
+      string call = Tmp(), obj = Tmp();
+      OS_ << "  " << call << " = call noalias nonnull i8* @_Znwm(i64 16)\n"
+          << "  " << obj << " = bitcast i8* " << call << " to %class.Box*\n"
+          << "  store %class.Box* " << obj << ", %class.Box** " << b << ", align 8\n";
+    }
+
+    // b.f = y; or x = b.f;
+    void Field(const string &b, const string &x, bool isLoad) {
+      string p = Tmp(), f = Tmp(), v = Tmp();
+      OS_ << "  " << p << " = load %class.Box*, %class.Box** " << b << ", align 8\n"
+          << "  " << f << " = getelementptr inbounds %class.Box, %class.Box* " << p << ", i32 0, i32 1\n";
+      if(isLoad) {
+        OS_ << "  " << v << " = load %class.C0*, %class.C0** " << f << ", align 8\n"
+            << "  store %class.C0* " << v << ", %class.C0** " << x << ", align 8\n";
+      } else {
+        OS_ << "  " << v << " = load %class.C0*, %class.C0** " << x << ", align 8\n"
+            << "  store %class.C0* " << v << ", %class.C0** " << f << ", align 8\n";
+      }
+    }
+
+    // Emits statement number i of a method and returns how many statements it took.
+    unsigned Statement(const string &shape, unsigned i) {
+      unsigned chain = std::max<unsigned>(Chain, 2);
+      if(shape == "hierarchy") { // new Ck, two copies, one call.
+        switch(i % 4) {
+        case 0: New(Var(i / 4), classes_[(i / 4) % Depth]); return 1;
+        case 1: Copy(Var(i / 4 + 1), Var(i / 4)); return 1;
+        case 2: Copy(Var(i / 4 + 3), Var(i / 4 + 1)); return 1;
+        default: VirtualCall(Var(i / 4)); return 1;
+        }
+      }
+      if(shape == "dispatch") { // new Wj, one call.
+        if(i % 2 == 0) {
+          New(Var(i / 2), classes_[Depth + (i / 2) % Width]);
+        } else {
+          VirtualCall(Var(i / 2));
+        }
+        return 1;
+      }
+      if(shape == "copies") { // vi = new; vi+1 = vi; ...; vi+chain-1 = vi+chain-2;
+        if(i % chain == 0) {
+          New(Var(i), classes_[(i / chain) % Depth]);
+        } else {
+          Copy(Var(i), Var(i - 1));
+        }
+        return 1;
+      }
+      if(shape == "cycles") { // One new per ring, then vb -> vb+1 -> ... -> vb.
+        unsigned k = i % (chain + 1), base = i / (chain + 1) * chain;
+        if(k == 0) {
+          New(Var(base), classes_[(i / (chain + 1)) % Depth]);
+        } else {
+          Copy(Var(base + k % chain), Var(base + k - 1));
+        }
+        return 1;
+      }
+      if(shape == "fields") { // new Box, new C0, b.f = v, w = b.f.
+        string b = "%b" + std::to_string((i / 4) % vars_);
+        switch(i % 4) {
+        case 0: NewBox(b); return 1;
+        case 1: New(Var(i / 4), classes_[(i / 4) % Depth]); return 1;
+        case 2: Field(b, Var(i / 4), false); return 1;
+        default: Field(b, Var(i / 4 + 1), true); return 1;
+        }
+      }
+      // mixed: every shape in turn.
+      static const char *const kinds[] = {"hierarchy", "dispatch", "copies", "cycles", "fields"};
+      return Statement(kinds[(i / 4) % 5], i);
+    }
+
+    void EmitDriverMethod(unsigned idx, unsigned n) {
+      string run = "run" + std::to_string(idx);
+      OS_ << "define dso_local void @" << Nested("Driver", std::to_string(run.size()) + run)
+          << "(%class.Driver* %this) align 2 {\n"
+          << "entry:\n"
+          << "  %this.addr = alloca %class.Driver*, align 8\n";
+      for(unsigned i = 0; i < vars_; i++) {
+        OS_ << "  %v" << i << " = alloca %class.C0*, align 8\n"
+            << "  %b" << i << " = alloca %class.Box*, align 8\n";
+      }
+      OS_ << "  store %class.Driver* %this, %class.Driver** %this.addr, align 8\n";
+      for(unsigned i = 0; i < n;) {
+        i += Statement(shape_, i);
+      }
+      OS_ << "  ret void\n}\n\n";
+    }
+
+    void EmitMain(unsigned methods) {
+      OS_ << "define dso_local i32 @main() {\n"
+          << "entry:\n"
+          << "  %dv = alloca %class.Driver*, align 8\n"
+          << "  %dcall = call noalias nonnull i8* @_Znwm(i64 1)\n"
+          << "  %d = bitcast i8* %dcall to %class.Driver*\n"
+          << "  store %class.Driver* %d, %class.Driver** %dv, align 8\n";
+      for(unsigned i = 0; i < methods; i++) {
+        string run = "run" + std::to_string(i);
+        string p = Tmp();
+        OS_ << "  " << p << " = load %class.Driver*, %class.Driver** %dv, align 8\n"
+            << "  call void @" << Nested("Driver", std::to_string(run.size()) + run)
+            << "(%class.Driver* " << p << ")\n";
+      }
+      OS_ << "  ret i32 0\n}\n";
+    }
+
+    string shape_;
+    unsigned statements_;
+    string IR_;
+    raw_string_ostream OS_;
+    unsigned vars_; // Locals of each Driver method, enough for one chain.
+    vector<string> classes_;
+    unsigned tmp_ = 0;
+  };
+
+  // Generates, parses and solves one input. Returns the exit code of the case.
+  int RunCase(const string &shape, unsigned statements, StringRef report) {
+    string name = shape + "-" + std::to_string(statements);
+
+    auto start = std::chrono::steady_clock::now();
+    string IR = IRGen(shape, statements).Generate();
+    LLVMContext Context;
+    std::unique_ptr<Module> M = hytbench::ParseGenerated(IR, name, EmitDir, Context);
+    if(!M) {
+      return -1;
+    }
+    double genSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double runSeconds = hytbench::RunPass("hytDFA_PointerAnalysis", *M, Verbose);
+    if(runSeconds < 0) {
+      return -1;
+    }
+
+    json::Value r = hytbench::LastReport(report, [&](const json::Object &obj) {
+      return obj.getString("module") == StringRef(name);
+    });
+    outs() << shape << "," << statements << "," << format("%.3f", genSeconds) << "," << format("%.3f", runSeconds);
+    for(const char *key : {"solve_seconds", "peak_rss_kb", "worklist_pops", "propagated_bits",
+                           "nodes", "edges", "sets", "set_bits", "reachable_methods", "budget_exceeded"}) {
+      outs() << "," << hytbench::ReportField(r, key);
+    }
+    outs() << "\n";
+    outs().flush();
+    return 0;
+  }
+}
+
+int main(int argc, char **argv) {
+  PassRegistry &Registry = *PassRegistry::getPassRegistry();
+  initializeCore(Registry);
+  initializeAnalysis(Registry);
+  initializeTransformUtils(Registry);
+
+  cl::ParseCommandLineOptions(argc, argv, "Hyt pointer analysis benchmark\n");
+
+  // The statistics come from the pass itself, written with -hyt-pta-report.
+  cl::opt<string> *Report = hytbench::PassOption<string>("hyt-pta-report");
+  if(!Report) {
+    errs() << "[ERROR] The pointer analysis is not linked in.\n";
+    return -1;
+  }
+  if(Report->empty()) {
+    Report->setValue("hyt-pta-bench.jsonl");
+  }
+  string report = *Report;
+  // Large inputs can run for hours, so each case gets a budget unless one is given.
+  cl::opt<unsigned> *Budget = hytbench::PassOption<unsigned>("hyt-pta-time-budget");
+  if(Budget && Budget->getNumOccurrences() == 0) {
+    Budget->setValue(CaseBudget);
+  }
+  hytbench::QuietResults(Verbose);
+
+  vector<string> shapes(Shapes.begin(), Shapes.end());
+  if(shapes.empty()) {
+    shapes = {"hierarchy", "dispatch", "copies", "cycles", "fields", "mixed"};
+  }
+  for(const string &shape : shapes) {
+    if(shape != "hierarchy" && shape != "dispatch" && shape != "copies" && shape != "cycles" &&
+       shape != "fields" && shape != "mixed") {
+      errs() << "[ERROR] Unknown shape: " << shape << "\n";
+      return -1;
+    }
+  }
+  vector<unsigned> scales(Scales.begin(), Scales.end());
+  if(scales.empty()) {
+    scales = {1000, 10000, 100000, 1000000};
+  }
+
+  outs() << "shape,statements,generate_seconds,run_seconds,solve_seconds,peak_rss_kb,worklist_pops,"
+         << "propagated_bits,nodes,edges,sets,set_bits,reachable_methods,budget_exceeded\n";
+  outs().flush();
+
+  int ret = 0;
+  for(const string &shape : shapes) {
+    for(unsigned statements : scales) {
+      hytbench::CaseResult result = hytbench::RunIsolated([&] {
+        return RunCase(shape, statements, report);
+      }, 0);
+      if(result != hytbench::CaseOK) {
+        errs() << "[ERROR] Case " << shape << "-" << statements << " failed.\n";
+        ret = -1;
+      }
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,279 @@
+//
+//
+// Batch analysis driver
+//
+// Runs any of Reaching Definition, Live Variables, Available Expressions and
+// Pointer Analysis on many .bc/.ll files in one process. When all three data
+// flow analyses run, they run fused in one solver, hytDFA_Fused. The passes are
+// linked in and registered once, and every worker thread parses its files
+// into an LLVMContext of its own, which it keeps for all of them. The
+// -hyt-results of a file are written in one piece as soon as the file is
+// done, so files show up in the order they finish.
+//
+
+
+#include "HytResults.h"
+#include "HytTrace.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/Pass.h"
+#include "llvm/PassInfo.h"
+#include "llvm/PassRegistry.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+using namespace llvm;
+
+static cl::list<string> InputFiles(
+    cl::Positional, cl::ZeroOrMore,
+    cl::desc("<input .bc/.ll files>"));
+
+static cl::opt<string> FileList(
+    "file-list", cl::value_desc("file"), cl::init(""),
+    cl::desc("Also analyze the files named in <file>, one per line ('-' for stdin)"));
+
+static cl::list<string> Analyses(
+    "analysis", cl::CommaSeparated,
+    cl::desc("Analyses to run: rd, lva, aea, pta (default: all)"));
+
+static cl::opt<bool> LazyBodies(
+    "lazy-bodies", cl::init(true),
+    cl::desc("With -analysis=pta only, load the function bodies of bitcode when the pointer analysis reaches them"));
+
+static cl::opt<bool> FuseDFA(
+    "fuse-dfa", cl::init(true),
+    cl::desc("Run rd, lva and aea as one solver over each function when all three are selected"));
+
+static cl::opt<unsigned> Jobs(
+    "j", cl::value_desc("n"), cl::init(0),
+    cl::desc("Files analyzed at once (default: all cores)"));
+
+namespace {
+  struct Analysis {
+    const char *name; // -analysis value.
+    const char *pass; // Registered pass argument.
+  };
+
+  const Analysis kAnalyses[] = {
+    {"rd", "hytDFA_ReachingDefinition"},
+    {"lva", "hytDFA_LiveVariables"},
+    {"aea", "hytDFA_AvailableExpresions"},
+    {"pta", "hytDFA_PointerAnalysis"},
+  };
+
+  // Replaces rd, lva and aea with -fuse-dfa.
+  const Analysis kFused = {"fused", "hytDFA_Fused"};
+
+  // Whether the pointer analysis starts from the functions visible outside
+  // each file because -hyt-pta-roots was not given, see main().
+  bool externalRoots = false;
+  // Whether files are opened with lazy function bodies, see main().
+  bool lazy = false;
+
+  // Gives the pass option `name` the value `value`, unless it was given.
+  void DefaultOption(StringRef name, StringRef value) {
+    cl::Option *O = cl::getRegisteredOptions().lookup(name);
+    if(O && O->getNumOccurrences() == 0) {
+      O->addOccurrence(0, name, value);
+    }
+  }
+
+  // Reads the file list, skipping empty lines and '#' comments.
+  bool ReadFileList(StringRef path, vector<string> &files) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> buffer = MemoryBuffer::getFileOrSTDIN(path);
+    if(!buffer) {
+      errs() << "[ERROR] Cannot read file list " << path << ": "
+             << buffer.getError().message() << "\n";
+      return false;
+    }
+    SmallVector<StringRef, 64> lines;
+    (*buffer)->getBuffer().split(lines, '\n', -1, false);
+    for(StringRef line : lines) {
+      line = line.trim();
+      if(line.empty() || line.startswith("#")) {
+        continue;
+      }
+      files.push_back(line.str());
+    }
+    return true;
+  }
+
+  // Parses `path` into Context and runs the passes on it. Returns false if
+  // the file could not be analyzed.
+  bool AnalyzeFile(const string &path, LLVMContext &Context, const vector<const Analysis *> &analyses) {
+    TimeTraceScope trace("AnalyzeFile", path);
+    hyt::ResultSink &results = hyt::Results();
+    auto start = std::chrono::steady_clock::now();
+    results.Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                   << " Analyzing " << path << "\n";
+
+    // Diagnostics are printed in one piece, the other workers print theirs too.
+    string diag;
+    raw_string_ostream DOS(diag);
+    SMDiagnostic Err;
+    // Text IR is always parsed in full.
+    std::unique_ptr<Module> M = lazy ? getLazyIRFileModule(path, Err, Context)
+                                     : parseIRFile(path, Err, Context);
+    if(!M) {
+      Err.print("hyt-analyze", DOS);
+      errs() << DOS.str();
+      return false;
+    }
+    if(verifyModule(*M, &DOS)) {
+      DOS << "[ERROR] " << path << " is broken.\n";
+      errs() << DOS.str();
+      return false;
+    }
+
+    unsigned functions = 0;
+    bool hasRoot = false;
+    for(Function &F : *M) {
+      if(!F.isDeclaration()) {
+        functions++;
+        hasRoot |= !F.hasLocalLinkage();
+      }
+    }
+    legacy::PassManager PM;
+    for(const Analysis *A : analyses) {
+      if(externalRoots && !hasRoot && StringRef(A->name) == "pta") {
+        errs() << "[Warning] " << path << " defines no function visible outside it, pointer analysis skipped.\n";
+        continue;
+      }
+      PM.add(PassRegistry::getPassRegistry()->getPassInfo(StringRef(A->pass))->createPass());
+    }
+    PM.run(*M);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    results.Begin("hyt-analyze", path);
+    results.Count("functions", functions);
+    results.Count("milliseconds", (uint64_t)(seconds * 1000));
+    results.End();
+    results.Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                   << " Analyzed " << path << " in " << format("%.3f", seconds) << " s\n";
+    return true;
+  }
+}
+
+int main(int argc, char **argv) {
+  PassRegistry &Registry = *PassRegistry::getPassRegistry();
+  initializeCore(Registry);
+  initializeAnalysis(Registry);
+  initializeTransformUtils(Registry);
+
+  cl::ParseCommandLineOptions(argc, argv, "Hyt batch analysis driver\n");
+
+  vector<string> files(InputFiles.begin(), InputFiles.end());
+  if(!FileList.empty() && !ReadFileList(FileList, files)) {
+    return -1;
+  }
+  if(files.empty()) {
+    errs() << "[ERROR] No input files.\n";
+    return -1;
+  }
+
+  vector<const Analysis *> analyses;
+  for(const Analysis &A : kAnalyses) {
+    if(Analyses.empty() || llvm::is_contained(Analyses, A.name)) {
+      analyses.push_back(&A);
+    }
+  }
+  for(const string &name : Analyses) {
+    if(name != "rd" && name != "lva" && name != "aea" && name != "pta") {
+      errs() << "[ERROR] Unknown analysis: " << name << "\n";
+      return -1;
+    }
+  }
+  // One summary, block order and solver per function instead of three.
+  auto isDFA = [](const Analysis *A) { return StringRef(A->name) != "pta"; };
+  if(FuseDFA && llvm::count_if(analyses, isDFA) == 3) {
+    llvm::erase_if(analyses, isDFA);
+    analyses.insert(analyses.begin(), &kFused);
+  }
+  for(const Analysis *A : analyses) {
+    if(!Registry.getPassInfo(StringRef(A->pass))) {
+      errs() << "[ERROR] " << A->pass << " is not linked in.\n";
+      return -1;
+    }
+  }
+
+  // The data flow analyses visit every body, the pointer analysis only
+  // those it reaches.
+  lazy = LazyBodies && analyses.size() == 1 && StringRef(analyses[0]->name) == "pta";
+
+  unsigned workers = std::min<size_t>(hardware_concurrency(Jobs).compute_thread_count(), files.size());
+  if(workers > 1 && TimePassesIsEnabled) {
+    errs() << "[Warning] -time-passes needs one file at a time, running with -j=1.\n";
+    workers = 1;
+  }
+  // Most files have no main, so the pointer analysis starts from what each
+  // file exports. The files already keep all cores busy.
+  cl::Option *RootsOpt = cl::getRegisteredOptions().lookup("hyt-pta-roots");
+  externalRoots = RootsOpt && RootsOpt->getNumOccurrences() == 0;
+  DefaultOption("hyt-pta-roots", "external");
+  if(workers > 1) {
+    DefaultOption("hyt-pta-threads", "1");
+  }
+
+  hyt::ResultSink &results = hyt::Results();
+  // Workers print warnings to errs() while the results of other files are
+  // written, so errs() must not flush the results stream.
+  errs().tie(nullptr);
+  hyt::TimeTraceBegin("hyt-analyze");
+  bool tracing = timeTraceProfilerEnabled();
+
+  auto start = std::chrono::steady_clock::now();
+  std::atomic<size_t> next(0);
+  std::atomic<unsigned> failed(0);
+  std::mutex resultsLock;
+  {
+    ThreadPool pool(hardware_concurrency(workers));
+    for(unsigned w = 0; w < workers; w++) {
+      pool.async([&] {
+        hyt::TimeTraceThread traceThread(tracing);
+        LLVMContext Context;
+        for(size_t idx = next++; idx < files.size(); idx = next++) {
+          string buffer;
+          raw_string_ostream OS(buffer);
+          {
+            hyt::ResultCapture capture(OS);
+            if(!AnalyzeFile(files[idx], Context, analyses)) {
+              failed++;
+            }
+          }
+          std::lock_guard<std::mutex> lock(resultsLock);
+          results.Write(OS.str());
+          results.Flush();
+        }
+      });
+    }
+    pool.wait();
+  }
+  hyt::TimeTraceEnd();
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  results.Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                 << " Analyzed " << files.size() - failed << " file(s) in " << format("%.3f", seconds)
+                 << " s, " << failed << " failed\n";
+  results.Flush();
+  return failed ? 1 : 0;
+}
@@ -11,9 +11,25 @@
 #include "llvm/Pass.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
+
+#include "HytAnalysis.h"
+#include "HytMemory.h"
+#include "HytResults.h"
+#include "HytSummary.h"
+#include "HytTrace.h"
 
 #include <map>
 #include <string>
+#include <chrono>
 #include <stdint.h>
 
 using std::map;
@@ -24,8 +40,20 @@ using namespace llvm;
 
 
 
-#define DEBUG_TYPE "hytProgramAnalysis_ReachingDefinition"
-#define SHOW_INFO  //Show fact information and result. 
+#define DEBUG_TYPE "hytProgramAnalysis_AvailableExpressions"
+
+STATISTIC(NumRounds, "Rounds over all blocks");
+STATISTIC(NumTransferCalls, "Transfer function calls");
+STATISTIC(NumMeets, "Meet operations");
+STATISTIC(NumBitVectorAllocs, "Bit vectors allocated");
+
+// Timer regions, shown by -time-passes.
+static const char *const TimerGroupName = "hytAEA";
+static const char *const TimerGroupDesc = "Hyt Available Expressions";
+
+static cl::opt<string> ReportFile(
+    "hyt-aea-report", cl::value_desc("file"), cl::init(""),
+    cl::desc("Append the solver statistics of each function to <file> as one JSON line"));
 
 namespace {
   // hytProgramAnalysis.
@@ -53,39 +81,67 @@ namespace {
     //     for varable y, its mask is 01010
     //     for varable z, its mask is 00001 
     map<string, BitVector> fact_mask_;
+    // `exprFact_` maps the expression ids of the summary of the current
+    // function to their facts, the same text is one fact.
+    std::vector<uint32_t> exprFact_;
     bool is_anyone_changed_ = false;
+    // Solver statistics of the last function, see WriteReport().
+    uint32_t round_ = 0;
+    uint64_t visits_ = 0;
+    double initSeconds_ = 0;
+    double solveSeconds_ = 0;
     
-    // gen and kill vevtor for each basic block.
-    map<BasicBlock*, BitVector> genB_;
-    map<BasicBlock*, BitVector> killB_;
+    // Blocks of the current function by their ids in the IR summary, and
+    // the other way round.
+    std::vector<BasicBlock*> blocks_;
+    DenseMap<const BasicBlock*, uint32_t> blockId_;
+
+    // gen and kill vevtor for each basic block, by block id.
+    std::vector<BitVector> genB_;
+    std::vector<BitVector> killB_;
 
     // map<BasicBlock*, BitVector> inB_;
-    map<BasicBlock*, BitVector> outB_;
+    std::vector<BitVector> outB_;
+
+    // Heap of each structure after the last function, and its high-water
+    // mark per function, see -hyt-mem-report.
+    hyt::HeapUsageList heap_;
+    hyt::MemoryLedger memory_;
 
-    void PrintFact(map<string, uint32_t> fact) {
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Fact => index:\n" ;
-      for(map<string, uint32_t>::iterator it = fact.begin();
+    void PrintFact(const map<string, uint32_t> &fact) {
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsFull)) {
+        for(const pair<string const, uint32_t> &it : fact) {
+          results.Label("fact", it.second, it.first);
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsFull);
+      OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Fact => index:\n" ;
+      for(map<string, uint32_t>::const_iterator it = fact.begin();
           it != fact.end(); it++) {
-        errs() << (it->first) << " => " << it->second << '\n';
+        OS << (it->first) << " => " << it->second << '\n';
       }
     }
 
-    void PrintFactMask(map<Instruction*, BitVector> fact_mask) {
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Varable => Maks vector:\n" ;
-      for(map<Instruction*, BitVector>::iterator it = fact_mask.begin();
+    void PrintFactMask(const map<Instruction*, BitVector> &fact_mask) {
+      raw_ostream &OS = hyt::Results().Text(hyt::ResultsFull);
+      OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Varable => Maks vector:\n" ;
+      for(map<Instruction*, BitVector>::const_iterator it = fact_mask.begin();
           it != fact_mask.end(); it++) {
-        errs() << *(it->first) << " => ";
+        OS << *(it->first) << " => ";
         PrintBitVector(it->second);
       }
     }
     
-    void PrintBitVector(BitVector bit_vector) {
-      for(int i = 0; i < bit_vector.size(); i++) {
-        errs() << bit_vector[i] << " ";
+    void PrintBitVector(const BitVector &bit_vector) {
+      raw_ostream &OS = hyt::Results().Text(hyt::ResultsFull);
+      for(unsigned i = 0; i < bit_vector.size(); i++) {
+        OS << (bit_vector[i] ? "1 " : "0 ");
       }
-      errs() << "\n";
+      OS << "\n";
     }
 
     // @return true if this analysis is forward, otherwise false.
@@ -93,125 +149,58 @@ namespace {
       return true;
     }
 
-    // Give a expr in intermediate expr, this function will find its origin expr with defined varaiables.
-    string FindOperand(Value *v) {
-      Instruction *inst = dyn_cast<Instruction>(v);
-      string operand = ""; 
-      if (inst){ // Still an Opcode
-        string name = inst->getOpcodeName();
-        if(name == "alloca") { // Find the defined varaiable.
-          operand += " "; // use space at begaining of the varaiable to distiguish the variable from opcode.
-          operand += inst->getName().data(); // data() method, Convert StringRef to string
-        }else if(name == "load") { // It is a intermidiate varaiable created by compiler, it is still not the defined varaiable.
-          operand += FindOperand(inst->getOperand(0));
-        }else if (inst->isUnaryOp()  || // If it is Unary Operations.
-                  inst->isBinaryOp() || // If it is Binary Ops.
-                  inst->isShift()    || // If it is Shift Ops.
-                  inst->isBitwiseLogicOp()) {
-          for(int i =0; i< inst->	getNumOperands();i++) {
-            operand += FindOperand(inst->getOperand(i));
-            if(i != inst->	getNumOperands() - 1) {
-              operand += " "; // use space at end of varaiable to distiguish the variable from opcode.
-              operand += name;
-              operand += " "; // use space at begaining of next varaiable to distiguish the variable from opcode.
-            }
-          }
-        }
-      }else { // Not an Opcode, than it is a constant, return its value as string.
-        operand += " "; // use space at begaining of the constant. Just for align when print the result.
-        operand += v->getNameOrAsOperand(); 
-      }
-      return operand;
-    }
-
-    bool InitGenAndKill(Function *F) {
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-             <<" Start to init Gen and Kill with " 
-             << def_count_ << " definitions\n";
+    bool InitGenAndKill(const hyt::IRSummary &summary) {
+      TimeTraceScope trace("InitGenAndKill");
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                            <<" Start to init Gen and Kill with " 
+                            << def_count_ << " definitions\n";
+      genB_.clear();
+      killB_.clear();
       BitVector tmp_killB;
       BitVector tmp_genB;
-      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
+      for (uint32_t bb = 0; bb < summary.blocks.size(); bb++) {
         tmp_killB = BitVector(def_count_, false);  // Init zero vector for each block.
         tmp_genB = BitVector(def_count_, false);   // Init zero vector for each block.
-        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-          string inst_opcode_name = inst->getOpcodeName();
+        NumBitVectorAllocs += 2;
+        for (const hyt::IRSummary::Event &event : summary.EventsOf(bb)) {
           // Find used expr.
-          if (inst->isUnaryOp()  || // If it is Unary Operations.
-              inst->isBinaryOp() || // If it is Binary Ops.
-              inst->isShift()    || // If it is Shift Ops.
-              inst->isBitwiseLogicOp()) {  // If it is Bitwise Logic Operations.
-            string operand = "";
-            for(int i =0; i< inst->	getNumOperands();i++) {
-              operand += FindOperand(inst->getOperand(i));
-              if(i != inst->getNumOperands() - 1) {
-                operand += " ";
-                operand += inst_opcode_name;
-                operand += " ";
-              }
-            }
-            tmp_genB[fact_[operand + " "]] = true;
-          } else if (inst_opcode_name == "store") { // Find redefined variable.
-            Instruction *i = dyn_cast<Instruction>(inst->getOperand(1));
-
-            // add a space before and after this varaible to distinguish the variable from opcode. 
-            // e.g., expr is `c add b`, if we only test whether `a` is in expr, 
-            // the result will be false positive because `add` contains `a`. 
-            // Besides, if expr is `c sub d`, if we only test whether `b ` (with a space followed) is in expr,
-            // the result will be false positive as well because `sub ` contains `b `.
-            // So we must add space before and after a varaiable.
-            string varaiable = " "; 
-            varaiable += i->getName().data();
-            varaiable += " ";   
-
-            for(map<string, uint32_t>::iterator it = fact_.begin();
-                it != fact_.end(); it++) {
-              if(it->first.find(varaiable) != string::npos) {
-                tmp_killB[fact_[it->first]] = true; // kill the expr if it contains this varaiable.
-              }
+          if (event.kind == hyt::IRSummary::Operation) {
+            tmp_genB[exprFact_[event.id]] = true;
+          } else if (event.kind == hyt::IRSummary::Store && event.id < summary.variables) { // Find redefined variable.
+            for (uint32_t expr : summary.readers[event.id]) {
+              tmp_killB[exprFact_[expr]] = true; // kill the expr if it contains this varaiable.
             }
           }
-        
         }
-        genB_.insert(pair<BasicBlock*, BitVector>(dyn_cast<BasicBlock>(bb), tmp_genB));
-        killB_.insert(pair<BasicBlock*, BitVector>(dyn_cast<BasicBlock>(bb), tmp_killB));
+        genB_.push_back(tmp_genB);
+        killB_.push_back(tmp_killB);
       }
       return true;
     }
 
-    void DoInit(Function &F) {
-      Function *tmp = &F;
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-             <<" Start to find all definitions and get fact set\n";
-      for (Function::iterator bb = tmp->begin(); bb != tmp->end(); ++bb) {        
-        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-
-            if (inst->isUnaryOp()  || // If it is Unary Operations.
-                inst->isBinaryOp() || // If it is Binary Ops.
-                inst->isShift()    || // If it is Shift Ops.
-                inst->isBitwiseLogicOp()) {  // If it is Bitwise Logic Operations.
-
-              string inst_opcode_name = inst->getOpcodeName();
-              string operand = "";
-              for(int i =0; i< inst->	getNumOperands();i++) {
-                operand += FindOperand(inst->getOperand(i));
-                if(i != inst->	getNumOperands() - 1) { // if it is not the last operand.
-                  operand += " ";
-                  operand += inst_opcode_name;
-                  operand += " ";
-                }
-              }
-
-              if(fact_.find(operand + " ") == fact_.end()) { // Exclude the same expr.
-                fact_.insert(pair<string, uint32_t>(operand + " ", def_count_));
-                def_count_++;
-              }
-            }
+    void DoInit(Function &F, const hyt::IRSummary &summary) {
+      TimeTraceScope trace("DoInit");
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                            <<" Start to find all definitions and get fact set\n";
+      Optional<hyt::Region> region;
+      region.emplace("init", "Number expressions", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      blocks_ = summary.blocks;
+      blockId_ = summary.blockIds;
+      exprFact_.clear();
+      for (const string &expr : summary.expressions) {
+        pair<map<string, uint32_t>::iterator, bool> it =
+            fact_.insert(pair<string, uint32_t>(expr + " ", def_count_));
+        if (it.second) { // Exclude the same expr.
+          def_count_++;
         }
+        exprFact_.push_back(it.first->second);
       }
-#ifdef SHOW_INFO
-      PrintFact(fact_);
-#endif
-      InitGenAndKill(&F);
+      if(hyt::Results().Wants(hyt::ResultsFull)) {
+        region.emplace("print", "Print results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+        PrintFact(fact_);
+      }
+      region.emplace("genkill", "Build gen and kill sets", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      InitGenAndKill(summary);
     }
 
     // res = a - b, where 1-1 = 0, 0-1 = 0. 0-0 = 0, 1-0 = 1
@@ -222,6 +211,7 @@ namespace {
       }
       if(res.size() != a.size()) {
         res = BitVector(a.size(), false);
+        ++NumBitVectorAllocs;
       }
       for(size_t i = 0;i < a.size();i++) {
         // if and only if a[i] == true, b[i] == false, then a[i] - b[i] = 1
@@ -238,9 +228,10 @@ namespace {
     // @param in, current in vector IN[B]
     // @param out, current out vector OUT[B]
     void TransferFunction(
-        BasicBlock *bb, 
+        uint32_t bb, 
         BitVector &in,
         BitVector &out) {
+      ++NumTransferCalls;
       BitVector res;
       BitVectorSub(in, killB_[bb], res);
       res |= genB_[bb];
@@ -252,98 +243,233 @@ namespace {
 
     // res = a n b; // use intersection for must analysis.
     void MeetInto(BitVector &a, BitVector &b, BitVector &res) {
+      ++NumMeets;
       if(a.size() != b.size()) {
         errs() << "\033[31m" << "[ERROR] MeetInto error -- Operands size are not equal!\n" << "\033[0m";
         exit(-1);
       }
       if(res.size() != a.size()) {
         res = BitVector(a.size(), false);
+        ++NumBitVectorAllocs;
       }
       BitVector tmp = a;
+      ++NumBitVectorAllocs;
       tmp &= b;
       res = tmp;
     }
 
-    // Forward analysis for reaching definition on function F
-    void ForwardAnalysis(Function *F) {
+    // Forward analysis for available expressions on the blocks of the
+    // summary, over its predecessor arrays.
+    void ForwardAnalysis(const hyt::IRSummary &summary) {
+      TimeTraceScope trace("ForwardAnalysis");
       // Initializing OUT[entry] = empty;
       BitVector prev_out = BitVector(def_count_, false);
       // Traverse all basic block
       // For each block OUT[B] = U;
-      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
-          outB_.insert(
-              pair<BasicBlock*, BitVector>(
-                  dyn_cast<BasicBlock>(bb), 
-                  BitVector(def_count_, true)
-              )
-          );
-      }
+      uint32_t blocks = summary.blocks.size();
+      outB_.assign(blocks, BitVector(def_count_, true));
+      NumBitVectorAllocs += blocks + 1; // prev_out and one vector per block.
       
       // Do analysis if any out vector has changed.
-#ifdef SHOW_INFO
-      uint32_t round = 0; // Count travers round when do reaching difinition analysis.
-#endif 
+      round_ = 0; // Count travers round when do reaching difinition analysis.
+      visits_ = 0;
       do {
-#ifdef SHOW_INFO
         //errs() << round++ << "round";
-        round++;
-#endif
+        round_++;
+        ++NumRounds;
         is_anyone_changed_ = false;  // Initialize all things are not changed.
         // IN[B] = U (for all predecessor P of B) OUT[P]; 
         // Where IN[B] here is called prev_out;
-        for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
-          BasicBlock *basic_block = dyn_cast<BasicBlock>(bb);
-          if (bb != F->begin()) { // Not entry, need to consider meet operation.
-            for (BasicBlock *pred : predecessors(basic_block)) {
+        for (uint32_t bb = 0; bb < blocks; bb++) {
+          if (bb != 0) { // Not entry, need to consider meet operation.
+            for (uint32_t pred : summary.PredsOf(bb)) {
               MeetInto(prev_out, outB_[pred], prev_out);
             }
           } 
           
           // OUT[B] = genB U (IN[B] - killB);
-          TransferFunction(basic_block, prev_out, outB_[basic_block]);
+          visits_++;
+          TransferFunction(bb, prev_out, outB_[bb]);
           prev_out.reset();
         }
       }while(is_anyone_changed_);
-#ifdef SHOW_INFO
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Total " << round << " round(s) analysis.\n";
-#endif
+      hyt::Results().Text() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+                            << " Total " << round_ << " round(s) analysis.\n";
     }
 
 
-    void DoDataFlowAnalysis(Function *F) {
+    void DoDataFlowAnalysis(const hyt::IRSummary &summary) {
       if(IsForward()) {
-        errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-              <<" Start to do forward analysis.\n";
-        ForwardAnalysis(F);
+        hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                              <<" Start to do forward analysis.\n";
+        ForwardAnalysis(summary);
       } else {
         errs() << "[WARNING] Not supported now!\n";
       }
     }
 
-    bool runOnFunction(Function &F) override {
-      DoInit(F);
-      DoDataFlowAnalysis(&F);
-#ifdef SHOW_INFO
-      BasicBlock *basic_block;
-      for (Function::iterator bb = F.begin(); bb != F.end(); ++bb) {
-        basic_block = dyn_cast<BasicBlock>(bb);
-        errs() << "  ========================= \n";
-        errs() << "  For block: \n";
-        errs() << *basic_block << "\n";
-        errs() << "  Final OUT: ";
-        PrintBitVector(outB_[basic_block]);
-        errs() << "  ========================= \n";
-      }
-#endif
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
-             << " Finised\n";
+    // Append the solver statistics of F to -hyt-aea-report as one JSON line,
+    // so runs on different inputs or builds can be compared.
+    void WriteReport(Function &F) {
+      hyt::AppendReport(ReportFile, [&](json::OStream &J) {
+        J.attribute("analysis", "aea");
+        J.attribute("module", F.getParent()->getModuleIdentifier());
+        J.attribute("function", F.getName());
+        J.attribute("facts", (int64_t)def_count_);
+        J.attribute("blocks", (int64_t)F.size());
+        J.attribute("rounds", (int64_t)round_);
+        J.attribute("block_visits", (int64_t)visits_);
+        J.attribute("init_seconds", initSeconds_);
+        J.attribute("solve_seconds", solveSeconds_);
+      }, heap_);
+    }
+
+    // Estimated heap bytes of each structure.
+    hyt::HeapUsageList HeapUsage() {
+      return {
+        {"fact_", hyt::HeapBytes(fact_)},
+        {"fact_mask_", hyt::HeapBytes(fact_mask_)},
+        {"exprFact_", hyt::HeapBytes(exprFact_)},
+        {"blockId_", hyt::HeapBytes(blockId_)},
+        {"genB_", hyt::HeapBytes(genB_)},
+        {"killB_", hyt::HeapBytes(killB_)},
+        {"outB_", hyt::HeapBytes(outB_)},
+      };
+    }
+
+    void getAnalysisUsage(AnalysisUsage &AU) const override {
+      AU.addRequired<hyt::IRSummaryWrapperPass>();
+      AU.setPreservesAll();
+    }
+
+    bool doInitialization(Module &M) override {
+      hyt::TimeTraceBegin("hytDFA_AvailableExpresions");
+      return false;
+    }
 
+    bool doFinalization(Module &M) override {
+      if(hyt::MemoryLedger::Enabled()) {
+        memory_.PrintTop("hytDFA_AvailableExpresions", errs());
+      }
+      hyt::Results().Flush();
+      hyt::TimeTraceEnd();
       return false;
+    }
+
+    // Solve F and write -hyt-aea-report. The results are written by
+    // PrintResults(), so a new pass manager result can print them later.
+    void Solve(Function &F, const hyt::IRSummary &summary) {
+      hyt::ResultSink &results = hyt::Results();
+      results.Begin("aea", F.getName());
+      auto start = std::chrono::steady_clock::now();
+      DoInit(F, summary);
+      auto inited = std::chrono::steady_clock::now();
+      Optional<hyt::Region> region;
+      region.emplace("solve", "Solve", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      DoDataFlowAnalysis(summary);
+      region.reset();
+      if(hyt::MemoryLedger::Enabled()) { // The structures only grow while solving.
+        heap_ = HeapUsage();
+        for(pair<const char*, size_t> &usage : heap_) {
+          memory_.Sample(F.getName(), usage.first, usage.second);
+        }
+      }
+      initSeconds_ = std::chrono::duration<double>(inited - start).count();
+      solveSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - inited).count();
+      if(!ReportFile.empty()) {
+        WriteReport(F);
+      }
+    }
+
+    void PrintResults(Function &F) {
+      hyt::ResultSink &results = hyt::Results();
+      if(!results.InScope("aea", F.getName())) { // A cached result.
+        results.Begin("aea", F.getName());
+      }
+      Optional<hyt::Region> region;
+      if(results.Wants(hyt::ResultsFull)) {
+        region.emplace("print", "Print results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      }
+      if(results.WantsText(hyt::ResultsFull)) {
+        raw_ostream &OS = results.Text(hyt::ResultsFull);
+        for (uint32_t bb = 0; bb < blocks_.size(); bb++) {
+          OS << "  ========================= \n";
+          OS << "  For block: \n";
+          OS << *blocks_[bb] << "\n";
+          OS << "  Final OUT: ";
+          PrintBitVector(outB_[bb]);
+          OS << "  ========================= \n";
+        }
+      } else if(results.WantsRecords(hyt::ResultsFull)) { // Blocks by their position in F.
+        for (uint32_t bb = 0; bb < blocks_.size(); bb++) {
+          results.Label("block", bb, blocks_[bb]->getName());
+          results.Set("out", bb, outB_[bb]);
+        }
+      }
+      results.Count("facts", def_count_);
+      results.Count("blocks", F.size());
+      results.Count("rounds", round_);
+      results.End();
+      results.Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                     << " Finised\n";
+    }
 
+    bool runOnFunction(Function &F) override {
+      TimeTraceScope trace("hytDFA_AvailableExpresions", F.getName());
+      Solve(F, getAnalysis<hyt::IRSummaryWrapperPass>().Summary());
+      PrintResults(F);
+      return false;
     }
   };
 }
 
 char hytProgramAnalysis::ID = 0;
-static RegisterPass<hytProgramAnalysis> X("hytDFA_AvailableExpresions", "Hyt Program Analysis For Available Expresions");
\ No newline at end of file
+static RegisterPass<hytProgramAnalysis> X("hytDFA_AvailableExpresions", "Hyt Program Analysis For Available Expresions");
+
+// New pass manager, see HytAnalysis.h.
+namespace hyt {
+  AnalysisKey AvailableExpressionsAnalysis::Key;
+
+  AvailableExpressions::AvailableExpressions(std::unique_ptr<FunctionPass> solver) : solver_(std::move(solver)) {}
+  AvailableExpressions::AvailableExpressions(AvailableExpressions &&) = default;
+  AvailableExpressions::~AvailableExpressions() = default;
+
+  const map<string, uint32_t> &AvailableExpressions::Expressions() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->fact_;
+  }
+
+  const BitVector *AvailableExpressions::Out(const BasicBlock *BB) const {
+    hytProgramAnalysis *solver = static_cast<hytProgramAnalysis*>(solver_.get());
+    DenseMap<const BasicBlock*, uint32_t>::const_iterator it = solver->blockId_.find(BB);
+    return it == solver->blockId_.end() ? nullptr : &solver->outB_[it->second];
+  }
+
+  uint32_t AvailableExpressions::Rounds() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->round_;
+  }
+
+  void AvailableExpressions::Print(Function &F) const {
+    static_cast<hytProgramAnalysis*>(solver_.get())->PrintResults(F);
+  }
+
+  bool AvailableExpressions::invalidate(Function &F, const PreservedAnalyses &PA,
+                                        FunctionAnalysisManager::Invalidator &Inv) {
+    PreservedAnalyses::PreservedAnalysisChecker PAC = PA.getChecker<AvailableExpressionsAnalysis>();
+    if(!PAC.preserved() && !PAC.preservedSet<AllAnalysesOn<Function>>()) {
+      return true;
+    }
+    return Inv.invalidate<IRSummaryAnalysis>(F, PA);
+  }
+
+  AvailableExpressions AvailableExpressionsAnalysis::run(Function &F, FunctionAnalysisManager &AM) {
+    TimeTraceScope trace("hytDFA_AvailableExpresions", F.getName());
+    std::unique_ptr<hytProgramAnalysis> solver(new hytProgramAnalysis());
+    solver->Solve(F, AM.getResult<IRSummaryAnalysis>(F));
+    return AvailableExpressions(std::move(solver));
+  }
+
+  PreservedAnalyses AvailableExpressionsPrinterPass::run(Function &F, FunctionAnalysisManager &AM) {
+    AM.getResult<AvailableExpressionsAnalysis>(F).Print(F);
+    return PreservedAnalyses::all();
+  }
+}
@@ -0,0 +1,212 @@
+//
+//
+// New pass manager interface of the analyses
+//
+// Each analysis is an AnalysisInfoMixin, so the FunctionAnalysisManager
+// (ModuleAnalysisManager for the pointer analysis) computes its result once
+// and hands the cached result to every later pass, until a pass does not
+// preserve it. A result keeps the solver that computed it; its accessors
+// read the solver's final sets.
+//
+// With `opt -load-pass-plugin LLVMHytDFA.so`:
+//   print<hyt-rd>, print<hyt-lva>, print<hyt-aea>   function passes
+//   print<hyt-pta>, print<hyt-pta-callgraph>         module passes
+// print the results like the legacy passes do, and require<hyt-*> and
+// invalidate<hyt-*> compute and drop them.
+//
+
+#ifndef HYT_ANALYSIS_H
+#define HYT_ANALYSIS_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/Pass.h"
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+namespace llvm {
+  class BasicBlock;
+  class CallGraph;
+  class Function;
+  class Instruction;
+  class Module;
+  class Value;
+}
+
+namespace hyt {
+  // Reaching Definition of one function. Definitions are the stores of F,
+  // bit i of a set is the definition numbered i.
+  class ReachingDefinitions {
+  public:
+    explicit ReachingDefinitions(std::unique_ptr<llvm::FunctionPass> solver);
+    ReachingDefinitions(ReachingDefinitions &&);
+    ~ReachingDefinitions();
+
+    const std::map<llvm::Instruction*, uint32_t> &Definitions() const;
+    // Definitions that reach the end of BB, or nullptr if BB is not in F.
+    const llvm::BitVector *Out(const llvm::BasicBlock *BB) const;
+    uint32_t Rounds() const;
+    // Print the OUT of each block, as hytDFA_ReachingDefinition does.
+    void Print(llvm::Function &F) const;
+    // True unless the result and the IR summary it was solved from are
+    // both preserved.
+    bool invalidate(llvm::Function &F, const llvm::PreservedAnalyses &PA,
+                    llvm::FunctionAnalysisManager::Invalidator &Inv);
+
+  private:
+    std::unique_ptr<llvm::FunctionPass> solver_;
+  };
+
+  class ReachingDefinitionAnalysis : public llvm::AnalysisInfoMixin<ReachingDefinitionAnalysis> {
+    friend llvm::AnalysisInfoMixin<ReachingDefinitionAnalysis>;
+    static llvm::AnalysisKey Key;
+
+  public:
+    using Result = ReachingDefinitions;
+    Result run(llvm::Function &F, llvm::FunctionAnalysisManager &AM);
+  };
+
+  struct ReachingDefinitionPrinterPass : public llvm::PassInfoMixin<ReachingDefinitionPrinterPass> {
+    llvm::PreservedAnalyses run(llvm::Function &F, llvm::FunctionAnalysisManager &AM);
+    static bool isRequired() { return true; }
+  };
+
+  // Live Variables of one function. Variables are the allocas of F, bit i
+  // of a set is the variable numbered i.
+  class LiveVariables {
+  public:
+    explicit LiveVariables(std::unique_ptr<llvm::FunctionPass> solver);
+    LiveVariables(LiveVariables &&);
+    ~LiveVariables();
+
+    const std::map<llvm::Instruction*, uint32_t> &Variables() const;
+    // Variables live at the start of BB, or nullptr if BB is not in F.
+    const llvm::BitVector *In(const llvm::BasicBlock *BB) const;
+    uint32_t Rounds() const;
+    // Print the IN of each block, as hytDFA_LiveVariables does.
+    void Print(llvm::Function &F) const;
+    // True unless the result and the IR summary it was solved from are
+    // both preserved.
+    bool invalidate(llvm::Function &F, const llvm::PreservedAnalyses &PA,
+                    llvm::FunctionAnalysisManager::Invalidator &Inv);
+
+  private:
+    std::unique_ptr<llvm::FunctionPass> solver_;
+  };
+
+  class LiveVariablesAnalysis : public llvm::AnalysisInfoMixin<LiveVariablesAnalysis> {
+    friend llvm::AnalysisInfoMixin<LiveVariablesAnalysis>;
+    static llvm::AnalysisKey Key;
+
+  public:
+    using Result = LiveVariables;
+    Result run(llvm::Function &F, llvm::FunctionAnalysisManager &AM);
+  };
+
+  struct LiveVariablesPrinterPass : public llvm::PassInfoMixin<LiveVariablesPrinterPass> {
+    llvm::PreservedAnalyses run(llvm::Function &F, llvm::FunctionAnalysisManager &AM);
+    static bool isRequired() { return true; }
+  };
+
+  // Available Expressions of one function. Expressions are the unary,
+  // binary, shift and logic operations of F by their text, e.g. " a add  b ",
+  // so the same expression in two places is one fact. Bit i of a set is
+  // the expression numbered i.
+  class AvailableExpressions {
+  public:
+    explicit AvailableExpressions(std::unique_ptr<llvm::FunctionPass> solver);
+    AvailableExpressions(AvailableExpressions &&);
+    ~AvailableExpressions();
+
+    const std::map<std::string, uint32_t> &Expressions() const;
+    // Expressions available at the end of BB, or nullptr if BB is not in F.
+    const llvm::BitVector *Out(const llvm::BasicBlock *BB) const;
+    uint32_t Rounds() const;
+    // Print the OUT of each block, as hytDFA_AvailableExpresions does.
+    void Print(llvm::Function &F) const;
+    // True unless the result and the IR summary it was solved from are
+    // both preserved.
+    bool invalidate(llvm::Function &F, const llvm::PreservedAnalyses &PA,
+                    llvm::FunctionAnalysisManager::Invalidator &Inv);
+
+  private:
+    std::unique_ptr<llvm::FunctionPass> solver_;
+  };
+
+  class AvailableExpressionsAnalysis : public llvm::AnalysisInfoMixin<AvailableExpressionsAnalysis> {
+    friend llvm::AnalysisInfoMixin<AvailableExpressionsAnalysis>;
+    static llvm::AnalysisKey Key;
+
+  public:
+    using Result = AvailableExpressions;
+    Result run(llvm::Function &F, llvm::FunctionAnalysisManager &AM);
+  };
+
+  struct AvailableExpressionsPrinterPass : public llvm::PassInfoMixin<AvailableExpressionsPrinterPass> {
+    llvm::PreservedAnalyses run(llvm::Function &F, llvm::FunctionAnalysisManager &AM);
+    static bool isRequired() { return true; }
+  };
+
+  // Pointer Analysis of one module. Bit i of a points-to set is the
+  // allocation site Objects()[i].
+  class PointsTo {
+  public:
+    explicit PointsTo(std::unique_ptr<llvm::ModulePass> solver);
+    PointsTo(PointsTo &&);
+    ~PointsTo();
+
+    llvm::ArrayRef<llvm::Value*> Objects() const;
+    // True if the solver stopped on a -hyt-pta-*-budget. The sets and the
+    // call graph are then coarse but sound, see -hyt-pta-time-budget.
+    bool Partial() const;
+    // The objects pointer V may point to, the same sets -hytPTA-aa uses:
+    // V must be a load of a variable whose every store is a fresh allocation
+    // or a copy of such a variable, or a fresh allocation by new, new[] or
+    // malloc. nullptr for any other pointer, e.g. an argument or a variable
+    // whose address is taken.
+    const llvm::BitVector *PointsToSet(const llvm::Value *V) const;
+    // False if A and B both have a PointsToSet(), with no object in common.
+    bool MayAlias(const llvm::Value *A, const llvm::Value *B) const;
+    // The methods reached, including those taken from RTA if Partial().
+    llvm::ArrayRef<llvm::Function*> ReachableMethods() const;
+    // The call graph of the module with the virtual calls the analysis
+    // resolved, as an llvm::CallGraph.
+    const llvm::CallGraph &CallGraph() const;
+    // Print the results, as hytDFA_PointerAnalysis does.
+    void Print(llvm::Module &M) const;
+    // True unless the result is preserved. It reads the IR of every
+    // reachable method, so it depends on no other analysis.
+    bool invalidate(llvm::Module &M, const llvm::PreservedAnalyses &PA,
+                    llvm::ModuleAnalysisManager::Invalidator &Inv);
+
+  private:
+    std::unique_ptr<llvm::ModulePass> solver_;
+  };
+
+  class PointsToAnalysis : public llvm::AnalysisInfoMixin<PointsToAnalysis> {
+    friend llvm::AnalysisInfoMixin<PointsToAnalysis>;
+    static llvm::AnalysisKey Key;
+
+  public:
+    using Result = PointsTo;
+    Result run(llvm::Module &M, llvm::ModuleAnalysisManager &AM);
+  };
+
+  struct PointsToPrinterPass : public llvm::PassInfoMixin<PointsToPrinterPass> {
+    llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &AM);
+    static bool isRequired() { return true; }
+  };
+
+  // print<hyt-pta-callgraph>: print PointsTo::CallGraph() the way LLVM
+  // prints a CallGraph.
+  struct PointsToCallGraphPrinterPass : public llvm::PassInfoMixin<PointsToCallGraphPrinterPass> {
+    llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &AM);
+    static bool isRequired() { return true; }
+  };
+}
+
+#endif
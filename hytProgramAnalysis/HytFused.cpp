@@ -0,0 +1,512 @@
+//
+//
+// Reaching Definition, Live Variables and Available Expressions in one solver
+//
+// hytDFA_Fused computes the sets of hytDFA_ReachingDefinition,
+// hytDFA_LiveVariables and hytDFA_AvailableExpresions, but pays the setup
+// once per function: one IR summary, whose block numbering and CFG arrays
+// all three solve over, and one reverse post-order. The forward states of
+// RD and AEA sit side by side in one slab of words per block and are solved
+// in the same sweeps; LVA is solved backward, in post-order, over the same
+// numbering.
+// Facts are numbered per function, as by the new pass manager analyses. The
+// legacy passes keep numbering across the functions of a module, so from
+// the second function on their sets are wider and their indices shifted;
+// the output matches theirs only for the first function.
+//
+
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "HytMemory.h"
+#include "HytResults.h"
+#include "HytSummary.h"
+#include "HytTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+using std::pair;
+using std::string;
+using std::vector;
+using namespace llvm;
+
+#define DEBUG_TYPE "hytProgramAnalysis_Fused"
+
+STATISTIC(NumRounds, "Rounds over all blocks");
+STATISTIC(NumTransferCalls, "Transfer function calls");
+
+// Timer regions, shown by -time-passes.
+static const char *const TimerGroupName = "hytFused";
+static const char *const TimerGroupDesc = "Hyt Fused Data Flow Analysis";
+
+static cl::opt<string> ReportFile(
+    "hyt-fused-report", cl::value_desc("file"), cl::init(""),
+    cl::desc("Append the solver statistics of each function to <file> as one JSON line"));
+
+namespace {
+  // Bit sets of every block, `words` 64-bit words each, block after block.
+  struct Slab {
+    unsigned words = 0;
+    vector<uint64_t> bits;
+
+    void Init(uint32_t blocks, unsigned rowWords) {
+      words = rowWords;
+      bits.assign((size_t)blocks * words, 0);
+    }
+    uint64_t *operator[](uint32_t block) { return bits.data() + (size_t)block * words; }
+    const uint64_t *operator[](uint32_t block) const { return bits.data() + (size_t)block * words; }
+  };
+
+  unsigned WordsFor(unsigned bits) {
+    return (bits + 63) / 64;
+  }
+
+  void SetBit(uint64_t *row, unsigned bit) {
+    row[bit / 64] |= (uint64_t)1 << (bit % 64);
+  }
+
+  BitVector ToBitVector(const uint64_t *row, unsigned bits) {
+    BitVector bv(bits, false);
+    for(unsigned bit = 0; bit < bits; bit++) {
+      if(row[bit / 64] >> (bit % 64) & 1) {
+        bv.set(bit);
+      }
+    }
+    return bv;
+  }
+
+  // hytProgramAnalysis.
+  struct hytProgramAnalysis : public FunctionPass {
+    static char ID; // Pass identification, replacement for typeid
+    hytProgramAnalysis() : FunctionPass(ID) {}
+
+    // Facts of the current function: RD definitions are the stores in the
+    // order of the summary, LVA variables and AEA expressions are those of
+    // the summary.
+    vector<Instruction*> defs_;
+    uint32_t vars_ = 0;
+    uint32_t exprs_ = 0;
+
+    // Blocks in the order the forward sweeps visit them: reverse
+    // post-order, then the unreachable blocks. The backward sweeps visit
+    // them the other way round.
+    vector<uint32_t> order_;
+    // The summary the sets were built from: block ids, the CFG over them and
+    // the names of blocks and facts.
+    const hyt::IRSummary *summary_ = nullptr;
+
+    // Forward rows are the RD words, then the AEA words.
+    unsigned rdWords_ = 0;
+    unsigned aeaWords_ = 0;
+    Slab genB_;
+    Slab killB_;
+    Slab outB_;
+    // LVA rows.
+    Slab defB_;
+    Slab useB_;
+    Slab inB_;
+
+    // Solver statistics of the last function, see WriteReport().
+    uint32_t forwardRounds_ = 0;
+    uint32_t backwardRounds_ = 0;
+    uint64_t visits_ = 0;
+    double initSeconds_ = 0;
+    double solveSeconds_ = 0;
+
+    // Heap of each structure after the last function, and its high-water
+    // mark per function, see -hyt-mem-report.
+    hyt::HeapUsageList heap_;
+    hyt::MemoryLedger memory_;
+
+    // Blocks reachable from the entry into order_, in post-order, by a depth
+    // first search over the successor arrays.
+    void PostOrder(const hyt::IRSummary &summary) {
+      order_.clear();
+      vector<bool> seen(summary.blocks.size(), false);
+      vector<pair<uint32_t, uint32_t>> stack; // <block, next successor>
+      stack.push_back({0, 0});
+      seen[0] = true;
+      while(!stack.empty()) {
+        pair<uint32_t, uint32_t> &top = stack.back();
+        ArrayRef<uint32_t> succs = summary.SuccsOf(top.first);
+        if(top.second == succs.size()) {
+          order_.push_back(top.first);
+          stack.pop_back();
+          continue;
+        }
+        uint32_t succ = succs[top.second++];
+        if(!seen[succ]) {
+          seen[succ] = true;
+          stack.push_back({succ, 0});
+        }
+      }
+    }
+
+    void DoInit(Function &F, const hyt::IRSummary &summary) {
+      TimeTraceScope trace("DoInit");
+      Optional<hyt::Region> region;
+      region.emplace("init", "Number blocks and facts", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      summary_ = &summary;
+      uint32_t blocks = summary.blocks.size();
+      PostOrder(summary);
+      std::reverse(order_.begin(), order_.end());
+      vector<bool> reached(blocks, false);
+      for(uint32_t bb : order_) {
+        reached[bb] = true;
+      }
+      for(uint32_t bb = 0; bb < blocks; bb++) {
+        if(!reached[bb]) {
+          order_.push_back(bb);
+        }
+      }
+
+      defs_.clear();
+      for(const hyt::IRSummary::Event &event : summary.events) {
+        if(event.kind == hyt::IRSummary::Store) {
+          defs_.push_back(event.inst);
+        }
+      }
+      vars_ = summary.variables;
+      exprs_ = summary.expressions.size();
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                            << " Start to init " << defs_.size() << " definitions, "
+                            << vars_ << " variables and " << exprs_ << " expressions\n";
+
+      region.emplace("genkill", "Build gen, kill, def and use sets", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      rdWords_ = WordsFor(defs_.size());
+      aeaWords_ = WordsFor(exprs_);
+      genB_.Init(blocks, rdWords_ + aeaWords_);
+      killB_.Init(blocks, rdWords_ + aeaWords_);
+      outB_.Init(blocks, rdWords_ + aeaWords_);
+      defB_.Init(blocks, WordsFor(vars_));
+      useB_.Init(blocks, WordsFor(vars_));
+      inB_.Init(blocks, WordsFor(vars_));
+
+      // The definitions of each location, and the last block that killed
+      // them, so a block kills them once however often it stores.
+      vector<vector<uint32_t>> defsOf(summary.locations.size());
+      vector<uint32_t> killedIn(summary.locations.size(), UINT32_MAX);
+      uint32_t def = 0;
+      for(const hyt::IRSummary::Event &event : summary.events) {
+        if(event.kind == hyt::IRSummary::Store) {
+          defsOf[event.id].push_back(def++);
+        }
+      }
+      def = 0;
+      for(uint32_t bb = 0; bb < blocks; bb++) {
+        uint64_t *gen = genB_[bb];
+        uint64_t *kill = killB_[bb];
+        uint64_t *defB = defB_[bb];
+        uint64_t *useB = useB_[bb];
+        for(const hyt::IRSummary::Event &event : summary.EventsOf(bb)) {
+          if(event.kind == hyt::IRSummary::Operation) { // AEA gen.
+            SetBit(gen + rdWords_, event.id);
+            continue;
+          }
+          bool isVar = event.id < summary.variables;
+          if(event.kind == hyt::IRSummary::Load) { // LVA use, unless defined before in B.
+            if(isVar && !(defB[event.id / 64] >> (event.id % 64) & 1)) {
+              SetBit(useB, event.id);
+            }
+            continue;
+          }
+          SetBit(gen, def++); // RD gen.
+          if(killedIn[event.id] != bb) {
+            killedIn[event.id] = bb;
+            for(uint32_t other : defsOf[event.id]) {
+              SetBit(kill, other);
+            }
+          }
+          if(isVar) {
+            SetBit(defB, event.id);
+            for(uint32_t expr : summary.readers[event.id]) { // AEA kill.
+              SetBit(kill + rdWords_, expr);
+            }
+          }
+        }
+      }
+      // OUT[B] = U for AEA.
+      for(uint32_t bb = 0; bb < blocks; bb++) {
+        uint64_t *out = outB_[bb] + rdWords_;
+        for(uint32_t expr = 0; expr < exprs_; expr++) {
+          SetBit(out, expr);
+        }
+      }
+    }
+
+    // OUT[B] = genB U (IN[B] - killB), for RD and AEA at once.
+    /// @return true if OUT[B] changed.
+    bool ForwardTransfer(uint32_t bb, const uint64_t *in) {
+      ++NumTransferCalls;
+      const uint64_t *gen = genB_[bb];
+      const uint64_t *kill = killB_[bb];
+      uint64_t *out = outB_[bb];
+      bool changed = false;
+      for(unsigned w = 0; w < outB_.words; w++) {
+        uint64_t res = gen[w] | (in[w] & ~kill[w]);
+        changed |= res != out[w];
+        out[w] = res;
+      }
+      return changed;
+    }
+
+    // IN[B] = useB U (OUT[B] - defB).
+    /// @return true if IN[B] changed.
+    bool BackwardTransfer(uint32_t bb, const uint64_t *out) {
+      ++NumTransferCalls;
+      const uint64_t *def = defB_[bb];
+      const uint64_t *use = useB_[bb];
+      uint64_t *in = inB_[bb];
+      bool changed = false;
+      for(unsigned w = 0; w < inB_.words; w++) {
+        uint64_t res = use[w] | (out[w] & ~def[w]);
+        changed |= res != in[w];
+        in[w] = res;
+      }
+      return changed;
+    }
+
+    // IN[B] = U OUT[P] for RD, n OUT[P] for AEA, both over the predecessors
+    // P of B; IN[entry] = empty.
+    // The AEA meet starts from the same empty IN as hytDFA_AvailableExpresions
+    // does, so both give the same sets.
+    void ForwardAnalysis() {
+      TimeTraceScope trace("ForwardAnalysis");
+      vector<uint64_t> in(outB_.words);
+      bool changed;
+      forwardRounds_ = 0;
+      do {
+        forwardRounds_++;
+        ++NumRounds;
+        changed = false;
+        for(uint32_t bb : order_) {
+          std::fill(in.begin(), in.end(), 0);
+          if(bb != 0) { // Not entry.
+            for(uint32_t pred : summary_->PredsOf(bb)) {
+              const uint64_t *out = outB_[pred];
+              for(unsigned w = 0; w < rdWords_; w++) {
+                in[w] |= out[w];
+              }
+              for(unsigned w = rdWords_; w < outB_.words; w++) {
+                in[w] &= out[w];
+              }
+            }
+          }
+          visits_++;
+          changed |= ForwardTransfer(bb, in.data());
+        }
+      } while(changed);
+    }
+
+    // OUT[B] = U IN[S] over the successors S of B.
+    void BackwardAnalysis() {
+      TimeTraceScope trace("BackwardAnalysis");
+      vector<uint64_t> out(inB_.words);
+      bool changed;
+      backwardRounds_ = 0;
+      do {
+        backwardRounds_++;
+        ++NumRounds;
+        changed = false;
+        for(vector<uint32_t>::reverse_iterator it = order_.rbegin(); it != order_.rend(); ++it) {
+          std::fill(out.begin(), out.end(), 0);
+          for(uint32_t succ : summary_->SuccsOf(*it)) {
+            const uint64_t *in = inB_[succ];
+            for(unsigned w = 0; w < inB_.words; w++) {
+              out[w] |= in[w];
+            }
+          }
+          visits_++;
+          changed |= BackwardTransfer(*it, out.data());
+        }
+      } while(changed);
+    }
+
+    void PrintFacts(StringRef pass) {
+      hyt::ResultSink &results = hyt::Results();
+      const hyt::IRSummary &summary = *summary_;
+      uint32_t count = pass == "rd" ? defs_.size() : pass == "lva" ? vars_ : exprs_;
+      bool records = results.WantsRecords(hyt::ResultsFull);
+      raw_ostream &OS = results.Text(hyt::ResultsFull);
+      if(!records) {
+        OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+           << " Fact => index:\n" ;
+      }
+      for(uint32_t fact = 0; fact < count; fact++) {
+        string text;
+        raw_string_ostream TS(text);
+        if(pass == "rd") {
+          TS << *defs_[fact];
+        } else if(pass == "lva") {
+          TS << *summary.locations[fact];
+        } else {
+          TS << summary.expressions[fact] << " ";
+        }
+        if(records) {
+          results.Label("fact", fact, TS.str());
+        } else {
+          OS << TS.str() << " => " << fact << '\n';
+        }
+      }
+    }
+
+    void PrintBitVector(const BitVector &bit_vector) {
+      raw_ostream &OS = hyt::Results().Text(hyt::ResultsFull);
+      for(unsigned i = 0; i < bit_vector.size(); i++) {
+        OS << (bit_vector[i] ? "1 " : "0 ");
+      }
+      OS << "\n";
+    }
+
+    // Write the results of one analysis as its own pass does, under the
+    // scope of that pass.
+    void PrintAnalysis(Function &F, StringRef pass) {
+      hyt::ResultSink &results = hyt::Results();
+      results.Begin(pass, F.getName());
+      bool isLVA = pass == "lva";
+      uint32_t facts = pass == "rd" ? defs_.size() : isLVA ? vars_ : exprs_;
+      const char *name = isLVA ? "in" : "out";
+      if(results.Wants(hyt::ResultsFull)) {
+        PrintFacts(pass);
+        for(uint32_t bb = 0; bb < summary_->blocks.size(); bb++) {
+          const uint64_t *row = isLVA ? inB_[bb] : outB_[bb] + (pass == "rd" ? 0 : rdWords_);
+          BitVector set = ToBitVector(row, facts);
+          if(results.WantsText(hyt::ResultsFull)) {
+            raw_ostream &OS = results.Text(hyt::ResultsFull);
+            OS << "  ========================= \n";
+            OS << "  For block: \n";
+            OS << *summary_->blocks[bb] << "\n";
+            OS << (isLVA ? "  Final IN: " : "  Final OUT: ");
+            PrintBitVector(set);
+            OS << "  ========================= \n";
+          } else {
+            results.Label("block", bb, summary_->blocks[bb]->getName());
+            results.Set(name, bb, set);
+          }
+        }
+      }
+      results.Count("facts", facts);
+      results.Count("blocks", summary_->blocks.size());
+      results.Count("rounds", isLVA ? backwardRounds_ : forwardRounds_);
+      results.End();
+    }
+
+    // Append the solver statistics of F to -hyt-fused-report as one JSON
+    // line. Facts and rounds are summed over the three analyses.
+    void WriteReport(Function &F) {
+      hyt::AppendReport(ReportFile, [&](json::OStream &J) {
+        J.attribute("analysis", "fused");
+        J.attribute("module", F.getParent()->getModuleIdentifier());
+        J.attribute("function", F.getName());
+        J.attribute("facts", (int64_t)(defs_.size() + vars_ + exprs_));
+        J.attribute("blocks", (int64_t)F.size());
+        J.attribute("rounds", (int64_t)(forwardRounds_ + backwardRounds_));
+        J.attribute("block_visits", (int64_t)visits_);
+        J.attribute("init_seconds", initSeconds_);
+        J.attribute("solve_seconds", solveSeconds_);
+      }, heap_);
+    }
+
+    // Estimated heap bytes of each structure.
+    hyt::HeapUsageList HeapUsage() {
+      return {
+        {"defs_", hyt::HeapBytes(defs_)},
+        {"order_", hyt::HeapBytes(order_)},
+        {"genB_", hyt::HeapBytes(genB_.bits)},
+        {"killB_", hyt::HeapBytes(killB_.bits)},
+        {"outB_", hyt::HeapBytes(outB_.bits)},
+        {"defB_", hyt::HeapBytes(defB_.bits)},
+        {"useB_", hyt::HeapBytes(useB_.bits)},
+        {"inB_", hyt::HeapBytes(inB_.bits)},
+      };
+    }
+
+    void getAnalysisUsage(AnalysisUsage &AU) const override {
+      AU.addRequired<hyt::IRSummaryWrapperPass>();
+      AU.setPreservesAll();
+    }
+
+    bool doInitialization(Module &M) override {
+      hyt::TimeTraceBegin("hytDFA_Fused");
+      return false;
+    }
+
+    bool doFinalization(Module &M) override {
+      if(hyt::MemoryLedger::Enabled()) {
+        memory_.PrintTop("hytDFA_Fused", errs());
+      }
+      hyt::Results().Flush();
+      hyt::TimeTraceEnd();
+      return false;
+    }
+
+    // Solve F and write -hyt-fused-report. The results are written by
+    // PrintResults(), under the scopes of the three analyses.
+    void Solve(Function &F, const hyt::IRSummary &summary) {
+      auto start = std::chrono::steady_clock::now();
+      DoInit(F, summary);
+      auto inited = std::chrono::steady_clock::now();
+      Optional<hyt::Region> region;
+      region.emplace("solve", "Solve", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      visits_ = 0;
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                            << " Start to do forward and backward analysis.\n";
+      ForwardAnalysis();
+      BackwardAnalysis();
+      region.reset();
+      hyt::Results().Text() << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+                            << " Total " << forwardRounds_ << " forward and "
+                            << backwardRounds_ << " backward round(s) analysis.\n";
+      if(hyt::MemoryLedger::Enabled()) {
+        heap_ = HeapUsage();
+        for(pair<const char*, size_t> &usage : heap_) {
+          memory_.Sample(F.getName(), usage.first, usage.second);
+        }
+      }
+      initSeconds_ = std::chrono::duration<double>(inited - start).count();
+      solveSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - inited).count();
+      if(!ReportFile.empty()) {
+        WriteReport(F);
+      }
+    }
+
+    void PrintResults(Function &F) {
+      Optional<hyt::Region> region;
+      if(hyt::Results().Wants(hyt::ResultsFull)) {
+        region.emplace("print", "Print results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      }
+      PrintAnalysis(F, "rd");
+      PrintAnalysis(F, "lva");
+      PrintAnalysis(F, "aea");
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                            << " Finised\n";
+    }
+
+    bool runOnFunction(Function &F) override {
+      TimeTraceScope trace("hytDFA_Fused", F.getName());
+      Solve(F, getAnalysis<hyt::IRSummaryWrapperPass>().Summary());
+      PrintResults(F);
+      return false;
+    }
+  };
+}
+
+char hytProgramAnalysis::ID = 0;
+static RegisterPass<hytProgramAnalysis> X("hytDFA_Fused", "Hyt Program Analysis For Reaching Definition, Live Variables And Available Expressions In One Solver");
@@ -12,9 +12,25 @@
 #include "llvm/Pass.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
+
+#include "HytAnalysis.h"
+#include "HytMemory.h"
+#include "HytResults.h"
+#include "HytSummary.h"
+#include "HytTrace.h"
 
 #include <map>
 #include <string>
+#include <chrono>
 #include <stdint.h>
 
 using std::map;
@@ -26,7 +42,19 @@ using namespace llvm;
 
 
 #define DEBUG_TYPE "hytProgramAnalysis_LiveVariables"
-#define SHOW_INFO  //Show fact information and result. 
+
+STATISTIC(NumRounds, "Rounds over all blocks");
+STATISTIC(NumTransferCalls, "Transfer function calls");
+STATISTIC(NumMeets, "Meet operations");
+STATISTIC(NumBitVectorAllocs, "Bit vectors allocated");
+
+// Timer regions, shown by -time-passes.
+static const char *const TimerGroupName = "hytLVA";
+static const char *const TimerGroupDesc = "Hyt Live Variables";
+
+static cl::opt<string> ReportFile(
+    "hyt-lva-report", cl::value_desc("file"), cl::init(""),
+    cl::desc("Append the solver statistics of each function to <file> as one JSON line"));
 
 namespace {
   // hytProgramAnalysis.
@@ -55,38 +83,66 @@ namespace {
     //     for varable z, its mask is 00001 
     map<Instruction*, BitVector> fact_mask_;
     bool is_anyone_changed_ = false;
+    // Solver statistics of the last function, see WriteReport().
+    uint32_t round_ = 0;
+    uint64_t visits_ = 0;
+    double initSeconds_ = 0;
+    double solveSeconds_ = 0;
     
-    // def and use vevtor for each basic block.
-    map<BasicBlock*, BitVector> defB_;
-    map<BasicBlock*, BitVector> useB_;
+    // Blocks of the current function by their ids in the IR summary, and
+    // the other way round.
+    std::vector<BasicBlock*> blocks_;
+    DenseMap<const BasicBlock*, uint32_t> blockId_;
 
-    map<BasicBlock*, BitVector> inB_;
+    // def and use vevtor for each basic block, by block id.
+    std::vector<BitVector> defB_;
+    std::vector<BitVector> useB_;
+
+    std::vector<BitVector> inB_;
+
+    // Heap of each structure after the last function, and its high-water
+    // mark per function, see -hyt-mem-report.
+    hyt::HeapUsageList heap_;
+    hyt::MemoryLedger memory_;
     //map<BasicBlock*, BitVector> outB_;
 
-    void PrintFact(map<Instruction*, uint32_t> fact) {
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Fact => index:\n" ;
-      for(map<Instruction*, uint32_t>::iterator it = fact.begin();
+    void PrintFact(const map<Instruction*, uint32_t> &fact) {
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsFull)) {
+        for(const pair<Instruction* const, uint32_t> &it : fact) {
+          string text;
+          raw_string_ostream OS(text);
+          OS << *it.first;
+          results.Label("fact", it.second, OS.str());
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsFull);
+      OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Fact => index:\n" ;
+      for(map<Instruction*, uint32_t>::const_iterator it = fact.begin();
           it != fact.end(); it++) {
-        errs() << *(it->first) << " => " << it->second << '\n';
+        OS << *(it->first) << " => " << it->second << '\n';
       }
     }
 
-    void PrintFactMask(map<Instruction*, BitVector> fact_mask) {
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Varable => Maks vector:\n" ;
-      for(map<Instruction*, BitVector>::iterator it = fact_mask.begin();
+    void PrintFactMask(const map<Instruction*, BitVector> &fact_mask) {
+      raw_ostream &OS = hyt::Results().Text(hyt::ResultsFull);
+      OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Varable => Maks vector:\n" ;
+      for(map<Instruction*, BitVector>::const_iterator it = fact_mask.begin();
           it != fact_mask.end(); it++) {
-        errs() << *(it->first) << " => ";
+        OS << *(it->first) << " => ";
         PrintBitVector(it->second);
       }
     }
     
-    void PrintBitVector(BitVector bit_vector) {
-      for(int i = 0; i < bit_vector.size(); i++) {
-        errs() << bit_vector[i] << " ";
+    void PrintBitVector(const BitVector &bit_vector) {
+      raw_ostream &OS = hyt::Results().Text(hyt::ResultsFull);
+      for(unsigned i = 0; i < bit_vector.size(); i++) {
+        OS << (bit_vector[i] ? "1 " : "0 ");
       }
-      errs() << "\n";
+      OS << "\n";
     }
 
     // @return true if this analysis is forward, otherwise false.
@@ -174,79 +230,59 @@ namespace {
 //       }
 //     }
 
-    void DoInit(Function &F) {
-      Function *tmp = &F;
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-             <<" Start to find all definitions and get fact set\n";
-
-      // test Backward traverse.
-      // for (Function::iterator bb = --tmp->end(); bb != --tmp->begin(); --bb) {
-      //   errs() << "====================================================\n";
-      //   errs() << "I am running on a block...\n";
-      //   errs() << "Block name: " << bb->getName().str() << "\n" ;//<< endl;
-      //   errs() << "Block content: " << *bb << "\n" ;
-      //   errs() << "====================================================\n";
-      // }
+    // The variables of F become the facts from def_count_ on, in the order
+    // of the summary.
+    void DoInit(Function &F, const hyt::IRSummary &summary) {
+      TimeTraceScope trace("DoInit");
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                            <<" Start to find all definitions and get fact set\n";
 
       // Find all exsit variables (facts), according to alloca opcode in all Basic Blocks
-      for (Function::iterator bb = tmp->begin(); bb != tmp->end(); ++bb) {      
-        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-          string inst_opcode_name = inst->getOpcodeName ();
-          if (inst_opcode_name == "alloca") {
-            fact_.insert(pair<Instruction*, uint32_t>(dyn_cast<Instruction>(inst), def_count_));
-            def_count_++;
-          }
-        }
+      Optional<hyt::Region> region;
+      region.emplace("init", "Number variables", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      blocks_ = summary.blocks;
+      blockId_ = summary.blockIds;
+      uint32_t first = def_count_;
+      for (uint32_t var = 0; var < summary.variables; var++) {
+        fact_.insert(pair<Instruction*, uint32_t>(cast<Instruction>(summary.locations[var]), def_count_));
+        def_count_++;
+      }
+      if(hyt::Results().Wants(hyt::ResultsFull)) {
+        region.emplace("print", "Print results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+        PrintFact(fact_);
       }
-#ifdef SHOW_INFO
-      PrintFact(fact_);
-#endif
+      region.emplace("genkill", "Build def and use sets", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
 
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-             << " Init defB and useB with " << def_count_ << " definitions\n";
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                            << " Init defB and useB with " << def_count_ << " definitions\n";
       // Init defB and useB for each Basic Block.
+      defB_.clear();
+      useB_.clear();
       BitVector tmp_defB = BitVector(def_count_, false);
       BitVector tmp_useB = BitVector(def_count_, false);
-      for (Function::iterator bb = tmp->begin(); bb != tmp->end(); ++bb) {
-        // errs() << "====================================================\n";
-        // errs() << "I am running on a block...\n";
-        // errs() << "Block name: " << bb->getName().str() << "\n" ;//<< endl;
-        // errs() << "Block content: " << *bb << "\n" ;
-
+      for (uint32_t bb = 0; bb < summary.blocks.size(); bb++) {
         // Find if some fact are used in this basic block
-        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-          // errs() << "left value: " << inst->getName() << "\n";
-          // errs() << *inst << "\n";
-          string inst_opcode_name = inst->getOpcodeName ();
-          // Find if some new def occored.
-          if (inst_opcode_name == "store") {
-            // The second operand of store instruction is the left value, 
-            // i.e., defined varable.
-            Instruction *varable = dyn_cast<Instruction>((inst->getOperand(1)));
-            tmp_defB[(fact_[varable])] = true; // set as def
+        for (const hyt::IRSummary::Event &event : summary.EventsOf(bb)) {
+          // Loads and stores through other pointers are not variables.
+          if (event.kind == hyt::IRSummary::Operation || event.id >= summary.variables) {
+            continue;
           }
-
-          if(inst_opcode_name == "load") {
-            // load only has one operand, and has one left value.
-            Instruction *varable = dyn_cast<Instruction>((inst->getOperand(0)));
-            // errs() << "\t[+] Opcode 0 name: " << *varable << "\n";
+          uint32_t index = first + event.id;
+          // Find if some new def occored.
+          if (event.kind == hyt::IRSummary::Store) {
+            tmp_defB[index] = true; // set as def
+          } else if (!tmp_defB[index]) {
             // If this fact has already redefined, than it would not be counted as use.
-            if (!tmp_defB[(fact_[varable])]) {
-              tmp_useB[(fact_[varable])] = true; // set as use
-            }
+            tmp_useB[index] = true; // set as use
           }
-
         }
 
         // save current basic block's defB and useB. 
-        //PrintBitVector(tmp_defB);
-        //PrintBitVector(tmp_useB);
-        defB_.insert(pair<BasicBlock*, BitVector>(dyn_cast<BasicBlock>(bb), tmp_defB));
-        useB_.insert(pair<BasicBlock*, BitVector>(dyn_cast<BasicBlock>(bb), tmp_useB));
+        defB_.push_back(tmp_defB);
+        useB_.push_back(tmp_useB);
+        NumBitVectorAllocs += 2;
         tmp_defB.reset(); // set tmp_defB = [ 0, 0, ....., 0 ];
         tmp_useB.reset(); // set tmp_useB = [ 0, 0, ....., 0 ];
-
-        //errs() << "====================================================\n";
       }
       
     }
@@ -261,6 +297,7 @@ namespace {
       }
       if(res.size() != a.size()) {
         res = BitVector(a.size(), false);
+        ++NumBitVectorAllocs;
       }
       for(size_t i = 0;i < a.size();i++) {
         // if and only if a[i] == true, b[i] == false, then a[i] - b[i] = 1
@@ -277,9 +314,10 @@ namespace {
     /// @param in, current in vector IN[B]
     /// @param out, current out vector OUT[B]
     void TransferFunction(
-        BasicBlock *bb, 
+        uint32_t bb, 
         BitVector &in,
         BitVector &out) {
+      ++NumTransferCalls;
       BitVector res;
       BitVectorSub(out, defB_[bb], res);
       res |= useB_[bb];
@@ -291,110 +329,245 @@ namespace {
 
     // res = a U b;
     void MeetInto(BitVector &a, BitVector &b, BitVector &res) {
+      ++NumMeets;
       if(a.size() != b.size()) {
         errs() << "\033[31m" << "[ERROR] MeetInto error -- Operands size are not equal!\n" << "\033[0m";
         exit(-1);
       }
       if(res.size() != a.size()) {
         res = BitVector(a.size(), false);
+        ++NumBitVectorAllocs;
       }
       BitVector tmp = a;
+      ++NumBitVectorAllocs;
       tmp |= b;
       res = tmp;
     }
 
     // Forward analysis is empty
-    void ForwardAnalysis(Function *F) {
+    void ForwardAnalysis(const hyt::IRSummary &summary) {
       
     }
 
-    // Backward analysis for live variables on function F
-    void BackwardAnalysis(Function *F) {
+    // Backward analysis for live variables on the blocks of the summary,
+    // over its successor arrays.
+    void BackwardAnalysis(const hyt::IRSummary &summary) {
+      TimeTraceScope trace("BackwardAnalysis");
       // Initializing IN[exit] = empty;
       // Then for the last basic block B, OUT[B] = IN[exit] = empty;
       BitVector outB = BitVector(def_count_, false);
       // Traverse all basic block
       // For each block IN[B] = empty;
-      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
-        inB_.insert(
-            pair<BasicBlock*, BitVector>(
-                dyn_cast<BasicBlock>(bb), 
-                BitVector(def_count_, false)
-            )
-        );
-      }
+      uint32_t blocks = summary.blocks.size();
+      inB_.assign(blocks, BitVector(def_count_, false));
+      NumBitVectorAllocs += blocks + 1; // outB and one vector per block.
       
       // Do analysis if any out vector has changed.
-#ifdef SHOW_INFO
-      uint32_t round = 0; // Count travers round when do reaching difinition analysis.
-#endif 
+      round_ = 0; // Count travers round when do reaching difinition analysis.
+      visits_ = 0;
       do {
-#ifdef SHOW_INFO
         //errs() << round++ << "round";
-        round++;
-#endif
+        round_++;
+        ++NumRounds;
         is_anyone_changed_ = false;  // Initialize all things are not changed.
         // OUT[B] = U (for all successors S of B) IN[S]; 
         // Where OUT[B] here is called outB;
-        for (Function::iterator bb = --F->end(); bb != --F->begin(); --bb) {
-          BasicBlock *basic_block = dyn_cast<BasicBlock>(bb);
+        for (uint32_t bb = blocks; bb-- > 0;) {
           // if (bb != --F->end()) { // If it is not final basic block, need to consider meet operation.
           // Do meet operation
-          for (BasicBlock *succ : successors(basic_block)) {
+          for (uint32_t succ : summary.SuccsOf(bb)) {
             MeetInto(outB, inB_[succ], outB);
           }
           // } 
           
           // IN[B] = useB U (OUT[B] - defB);
-          TransferFunction(basic_block, inB_[basic_block], outB);
+          visits_++;
+          TransferFunction(bb, inB_[bb], outB);
           outB.reset(); // set outB = [ 0, 0, ....., 0 ];
         }
       }while(is_anyone_changed_);
-#ifdef SHOW_INFO
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Total " << round << " round(s) analysis.\n";
-#endif
+      hyt::Results().Text() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+                            << " Total " << round_ << " round(s) analysis.\n";
     }
 
 
-    void DoDataFlowAnalysis(Function *F) {
+    void DoDataFlowAnalysis(const hyt::IRSummary &summary) {
       if(IsForward()) {
-        errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-              <<" Start to do forward analysis.\n";
-        ForwardAnalysis(F);
+        hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                              <<" Start to do forward analysis.\n";
+        ForwardAnalysis(summary);
       } else {
         // errs() << "[WARNING] Not supported now!\n";
-        errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-              <<" Start to do backward analysis.\n";
-        BackwardAnalysis(F);
+        hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                              <<" Start to do backward analysis.\n";
+        BackwardAnalysis(summary);
       }
     }
 
     
 
-    bool runOnFunction(Function &F) override {
+    // Append the solver statistics of F to -hyt-lva-report as one JSON line,
+    // so runs on different inputs or builds can be compared.
+    void WriteReport(Function &F) {
+      hyt::AppendReport(ReportFile, [&](json::OStream &J) {
+        J.attribute("analysis", "lva");
+        J.attribute("module", F.getParent()->getModuleIdentifier());
+        J.attribute("function", F.getName());
+        J.attribute("facts", (int64_t)def_count_);
+        J.attribute("blocks", (int64_t)F.size());
+        J.attribute("rounds", (int64_t)round_);
+        J.attribute("block_visits", (int64_t)visits_);
+        J.attribute("init_seconds", initSeconds_);
+        J.attribute("solve_seconds", solveSeconds_);
+      }, heap_);
+    }
+
+    // Estimated heap bytes of each structure.
+    hyt::HeapUsageList HeapUsage() {
+      return {
+        {"fact_", hyt::HeapBytes(fact_)},
+        {"fact_mask_", hyt::HeapBytes(fact_mask_)},
+        {"blockId_", hyt::HeapBytes(blockId_)},
+        {"defB_", hyt::HeapBytes(defB_)},
+        {"useB_", hyt::HeapBytes(useB_)},
+        {"inB_", hyt::HeapBytes(inB_)},
+      };
+    }
+
+    void getAnalysisUsage(AnalysisUsage &AU) const override {
+      AU.addRequired<hyt::IRSummaryWrapperPass>();
+      AU.setPreservesAll();
+    }
+
+    bool doInitialization(Module &M) override {
+      hyt::TimeTraceBegin("hytDFA_LiveVariables");
+      return false;
+    }
+
+    bool doFinalization(Module &M) override {
+      if(hyt::MemoryLedger::Enabled()) {
+        memory_.PrintTop("hytDFA_LiveVariables", errs());
+      }
+      hyt::Results().Flush();
+      hyt::TimeTraceEnd();
+      return false;
+    }
+
+    // Solve F and write -hyt-lva-report. The results are written by
+    // PrintResults(), so a new pass manager result can print them later.
+    void Solve(Function &F, const hyt::IRSummary &summary) {
+      hyt::ResultSink &results = hyt::Results();
+      results.Begin("lva", F.getName());
       // testDoInit(F);
-      DoInit(F);
-      DoDataFlowAnalysis(&F);
-#ifdef SHOW_INFO
-      BasicBlock *basic_block;
-      for (Function::iterator bb = F.begin(); bb != F.end(); ++bb) {
-        basic_block = dyn_cast<BasicBlock>(bb);
-        errs() << "  ========================= \n";
-        errs() << "  For block: \n";
-        errs() << *basic_block << "\n";
-        errs() << "  Final IN: ";
-        PrintBitVector(inB_[basic_block]);
-        errs() << "  ========================= \n";
+      auto start = std::chrono::steady_clock::now();
+      DoInit(F, summary);
+      auto inited = std::chrono::steady_clock::now();
+      Optional<hyt::Region> region;
+      region.emplace("solve", "Solve", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      DoDataFlowAnalysis(summary);
+      region.reset();
+      if(hyt::MemoryLedger::Enabled()) { // The structures only grow while solving.
+        heap_ = HeapUsage();
+        for(pair<const char*, size_t> &usage : heap_) {
+          memory_.Sample(F.getName(), usage.first, usage.second);
+        }
+      }
+      initSeconds_ = std::chrono::duration<double>(inited - start).count();
+      solveSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - inited).count();
+      if(!ReportFile.empty()) {
+        WriteReport(F);
       }
-#endif
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
-             << " Finised\n";
+    }
 
+    void PrintResults(Function &F) {
+      hyt::ResultSink &results = hyt::Results();
+      if(!results.InScope("lva", F.getName())) { // A cached result.
+        results.Begin("lva", F.getName());
+      }
+      Optional<hyt::Region> region;
+      if(results.Wants(hyt::ResultsFull)) {
+        region.emplace("print", "Print results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      }
+      if(results.WantsText(hyt::ResultsFull)) {
+        raw_ostream &OS = results.Text(hyt::ResultsFull);
+        for (uint32_t bb = 0; bb < blocks_.size(); bb++) {
+          OS << "  ========================= \n";
+          OS << "  For block: \n";
+          OS << *blocks_[bb] << "\n";
+          OS << "  Final IN: ";
+          PrintBitVector(inB_[bb]);
+          OS << "  ========================= \n";
+        }
+      } else if(results.WantsRecords(hyt::ResultsFull)) { // Blocks by their position in F.
+        for (uint32_t bb = 0; bb < blocks_.size(); bb++) {
+          results.Label("block", bb, blocks_[bb]->getName());
+          results.Set("in", bb, inB_[bb]);
+        }
+      }
+      results.Count("facts", def_count_);
+      results.Count("blocks", F.size());
+      results.Count("rounds", round_);
+      results.End();
+      results.Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                     << " Finised\n";
+    }
+
+    bool runOnFunction(Function &F) override {
+      TimeTraceScope trace("hytDFA_LiveVariables", F.getName());
+      Solve(F, getAnalysis<hyt::IRSummaryWrapperPass>().Summary());
+      PrintResults(F);
       return false;
     }
   };
 }
 
 char hytProgramAnalysis::ID = 0;
-static RegisterPass<hytProgramAnalysis> X("hytDFA_LiveVariables", "Hyt Program Analysis For Live Variables");
\ No newline at end of file
+static RegisterPass<hytProgramAnalysis> X("hytDFA_LiveVariables", "Hyt Program Analysis For Live Variables");
+
+// New pass manager, see HytAnalysis.h.
+namespace hyt {
+  AnalysisKey LiveVariablesAnalysis::Key;
+
+  LiveVariables::LiveVariables(std::unique_ptr<FunctionPass> solver) : solver_(std::move(solver)) {}
+  LiveVariables::LiveVariables(LiveVariables &&) = default;
+  LiveVariables::~LiveVariables() = default;
+
+  const map<Instruction*, uint32_t> &LiveVariables::Variables() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->fact_;
+  }
+
+  const BitVector *LiveVariables::In(const BasicBlock *BB) const {
+    hytProgramAnalysis *solver = static_cast<hytProgramAnalysis*>(solver_.get());
+    DenseMap<const BasicBlock*, uint32_t>::const_iterator it = solver->blockId_.find(BB);
+    return it == solver->blockId_.end() ? nullptr : &solver->inB_[it->second];
+  }
+
+  uint32_t LiveVariables::Rounds() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->round_;
+  }
+
+  void LiveVariables::Print(Function &F) const {
+    static_cast<hytProgramAnalysis*>(solver_.get())->PrintResults(F);
+  }
+
+  bool LiveVariables::invalidate(Function &F, const PreservedAnalyses &PA,
+                                 FunctionAnalysisManager::Invalidator &Inv) {
+    PreservedAnalyses::PreservedAnalysisChecker PAC = PA.getChecker<LiveVariablesAnalysis>();
+    if(!PAC.preserved() && !PAC.preservedSet<AllAnalysesOn<Function>>()) {
+      return true;
+    }
+    return Inv.invalidate<IRSummaryAnalysis>(F, PA);
+  }
+
+  LiveVariables LiveVariablesAnalysis::run(Function &F, FunctionAnalysisManager &AM) {
+    TimeTraceScope trace("hytDFA_LiveVariables", F.getName());
+    std::unique_ptr<hytProgramAnalysis> solver(new hytProgramAnalysis());
+    solver->Solve(F, AM.getResult<IRSummaryAnalysis>(F));
+    return LiveVariables(std::move(solver));
+  }
+
+  PreservedAnalyses LiveVariablesPrinterPass::run(Function &F, FunctionAnalysisManager &AM) {
+    AM.getResult<LiveVariablesAnalysis>(F).Print(F);
+    return PreservedAnalyses::all();
+  }
+}
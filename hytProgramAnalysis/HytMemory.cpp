@@ -0,0 +1,109 @@
+//
+//
+// Heap accounting shared by the passes, see HytMemory.h.
+//
+
+
+#include "HytMemory.h"
+
+#include "llvm/ADT/Twine.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+
+#include <algorithm>
+
+#ifdef LLVM_ON_UNIX
+#include <sys/resource.h>
+#endif
+
+using namespace llvm;
+
+static cl::opt<bool> MemoryReport(
+    "hyt-mem-report", cl::init(false),
+    cl::desc("Track the heap of each structure of the hyt passes and print the largest ones"));
+
+static cl::opt<unsigned> MemoryTop(
+    "hyt-mem-top", cl::init(10),
+    cl::desc("Number of structures -hyt-mem-report prints"));
+
+namespace hyt {
+  bool MemoryLedger::Enabled() {
+    return MemoryReport;
+  }
+
+  void MemoryLedger::Sample(StringRef scope, StringRef structure, size_t bytes) {
+    std::string key = (scope + Twine('\0') + structure).str();
+    auto inserted = index_.try_emplace(key, entries_.size());
+    if(inserted.second) {
+      entries_.push_back(Entry{scope.str(), structure.str(), bytes});
+    } else {
+      Entry &e = entries_[inserted.first->second];
+      e.bytes = std::max(e.bytes, bytes);
+    }
+  }
+
+  size_t MemoryLedger::Peak(StringRef structure) const {
+    size_t bytes = 0;
+    for(const Entry &e : entries_) {
+      if(e.structure == structure) {
+        bytes = std::max(bytes, e.bytes);
+      }
+    }
+    return bytes;
+  }
+
+  void MemoryLedger::PrintTop(StringRef pass, raw_ostream &OS) const {
+    std::vector<const Entry*> top;
+    for(const Entry &e : entries_) {
+      top.push_back(&e);
+    }
+    size_t n = std::min<size_t>(MemoryTop, top.size());
+    std::partial_sort(top.begin(), top.begin() + n, top.end(), [](const Entry *a, const Entry *b) {
+      return a->bytes > b->bytes;
+    });
+
+    OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+       << " Largest structures of " << pass << ":\n";
+    for(size_t i = 0; i < n; i++) {
+      OS << "\t" << format("%10.1f", top[i]->bytes / 1024.0) << " KB  "
+         << top[i]->structure << " in " << top[i]->scope << "\n";
+    }
+    if(long peakRSS = PeakRSS()) {
+      OS << "\t" << format("%10.1f", (double)peakRSS) << " KB  peak RSS of the process\n";
+    }
+  }
+
+  long PeakRSS() {
+#ifdef LLVM_ON_UNIX
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0) {
+      return usage.ru_maxrss;
+    }
+#endif
+    return 0;
+  }
+
+  void AppendReport(StringRef file, function_ref<void(json::OStream &)> write, const HeapUsageList &heap) {
+    std::error_code EC;
+    raw_fd_ostream OS(file, EC, sys::fs::OF_Append);
+    if(EC) {
+      errs() << "[ERROR] Cannot open report file " << file << ": " << EC.message() << "\n";
+      return;
+    }
+    json::OStream J(OS);
+    J.object([&] {
+      write(J);
+      J.attribute("peak_rss_kb", (int64_t)PeakRSS());
+      if(!heap.empty()) {
+        json::Object bytes;
+        for(const std::pair<const char *, size_t> &usage : heap) {
+          bytes[usage.first] = (int64_t)usage.second;
+        }
+        J.attribute("heap_bytes", std::move(bytes));
+      }
+    });
+    OS << "\n";
+  }
+}
@@ -0,0 +1,173 @@
+//
+//
+// Heap accounting shared by the passes
+//
+// HeapBytes() estimates the heap a container owns: its buckets, nodes or
+// elements, plus whatever the elements own in turn (bit vectors, strings,
+// nested containers). std::map and std::set nodes are counted as four
+// pointers of tree links plus the element, malloc overhead is not counted.
+//
+// With -hyt-mem-report, each pass samples its structures into a
+// MemoryLedger and prints the -hyt-mem-top largest high-water marks when it
+// finishes. ContainerOf() gives the container of a std::queue, to walk it
+// without a copy.
+//
+// AppendReport() writes the JSON line of the -hyt-*-report options, with the
+// peak RSS and the heap of each structure after the attributes of the pass.
+//
+
+#ifndef HYT_MEMORY_H
+#define HYT_MEMORY_H
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <deque>
+#include <map>
+#include <queue>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hyt {
+  // @return the container of q, front first, to walk it without a copy.
+  template <typename T, typename C>
+  const C &ContainerOf(const std::queue<T, C> &q) {
+    // std::queue hides its container as the protected member `c`.
+    struct Access : std::queue<T, C> {
+      static const C &Of(const std::queue<T, C> &q) {
+        return q.*(&Access::c);
+      }
+    };
+    return Access::Of(q);
+  }
+
+  // Values that own no heap, e.g. ids, pointers and plain structs.
+  template <typename T>
+  typename std::enable_if<std::is_trivially_copyable<T>::value, size_t>::type
+  HeapBytes(const T &) {
+    return 0;
+  }
+
+  inline size_t HeapBytes(const llvm::BitVector &bv) {
+    return bv.getMemorySize();
+  }
+
+  inline size_t HeapBytes(const std::string &s) {
+    const char *self = reinterpret_cast<const char *>(&s);
+    if(s.data() >= self && s.data() < self + sizeof(s)) { // Short string, stored inline.
+      return 0;
+    }
+    return s.capacity() + 1;
+  }
+
+  template <typename A, typename B> size_t HeapBytes(const std::pair<A, B> &p);
+  template <typename T> size_t HeapBytes(const std::vector<T> &v);
+  template <typename T> size_t HeapBytes(const std::deque<T> &d);
+  template <typename T> size_t HeapBytes(const std::queue<T> &q);
+  template <typename T> size_t HeapBytes(const std::set<T> &s);
+  template <typename K, typename V> size_t HeapBytes(const std::map<K, V> &m);
+  template <typename T> size_t HeapBytes(const llvm::DenseSet<T> &s);
+  template <typename K, typename V> size_t HeapBytes(const llvm::DenseMap<K, V> &m);
+
+  // Links and color of a red-black tree node.
+  const size_t TreeNodeBytes = 4 * sizeof(void *);
+
+  template <typename A, typename B> size_t HeapBytes(const std::pair<A, B> &p) {
+    return HeapBytes(p.first) + HeapBytes(p.second);
+  }
+
+  template <typename T> size_t HeapBytes(const std::vector<T> &v) {
+    size_t bytes = v.capacity() * sizeof(T);
+    for(const T &e : v) {
+      bytes += HeapBytes(e);
+    }
+    return bytes;
+  }
+
+  template <typename T> size_t HeapBytes(const std::deque<T> &d) {
+    size_t bytes = d.size() * sizeof(T);
+    for(const T &e : d) {
+      bytes += HeapBytes(e);
+    }
+    return bytes;
+  }
+
+  template <typename T> size_t HeapBytes(const std::queue<T> &q) {
+    return HeapBytes(ContainerOf(q));
+  }
+
+  template <typename T> size_t HeapBytes(const std::set<T> &s) {
+    size_t bytes = s.size() * (TreeNodeBytes + sizeof(T));
+    for(const T &e : s) {
+      bytes += HeapBytes(e);
+    }
+    return bytes;
+  }
+
+  template <typename K, typename V> size_t HeapBytes(const std::map<K, V> &m) {
+    size_t bytes = m.size() * (TreeNodeBytes + sizeof(std::pair<const K, V>));
+    for(const std::pair<const K, V> &kv : m) {
+      bytes += HeapBytes(kv.first) + HeapBytes(kv.second);
+    }
+    return bytes;
+  }
+
+  template <typename T> size_t HeapBytes(const llvm::DenseSet<T> &s) {
+    return s.getMemorySize();
+  }
+
+  template <typename K, typename V> size_t HeapBytes(const llvm::DenseMap<K, V> &m) {
+    size_t bytes = m.getMemorySize();
+    for(const auto &kv : m) {
+      bytes += HeapBytes(kv.first) + HeapBytes(kv.second);
+    }
+    return bytes;
+  }
+
+  // High-water marks of the structures of one pass, per function or phase.
+  class MemoryLedger {
+  public:
+    // Whether -hyt-mem-report is on.
+    static bool Enabled();
+
+    // Raise the high-water mark of `structure` in `scope` to `bytes`.
+    void Sample(llvm::StringRef scope, llvm::StringRef structure, size_t bytes);
+
+    // The largest high-water mark of `structure` over all scopes.
+    size_t Peak(llvm::StringRef structure) const;
+
+    // Print the -hyt-mem-top largest high-water marks and the peak RSS.
+    void PrintTop(llvm::StringRef pass, llvm::raw_ostream &OS) const;
+
+  private:
+    struct Entry {
+      std::string scope;
+      std::string structure;
+      size_t bytes;
+    };
+    std::vector<Entry> entries_;
+    llvm::StringMap<unsigned> index_; // "<scope>\0<structure>" => entries_ index.
+  };
+
+  // Heap bytes of each structure of a pass, by structure name.
+  typedef std::vector<std::pair<const char *, size_t>> HeapUsageList;
+
+  // Peak RSS of the process in KB, or 0 where it is not known.
+  long PeakRSS();
+
+  // Append one JSON line to `file`: the attributes `write` adds, then
+  // peak_rss_kb and, unless `heap` is empty, heap_bytes.
+  void AppendReport(llvm::StringRef file, llvm::function_ref<void(llvm::json::OStream &)> write,
+                    const HeapUsageList &heap);
+}
+
+#endif
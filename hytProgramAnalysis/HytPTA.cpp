@@ -11,13 +11,52 @@
 #include "llvm/Pass.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
-
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/CallGraph.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/PassInfo.h"
+#include "llvm/PassRegistry.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Transforms/Utils/CallPromotionUtils.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/IR/ValueMap.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/xxhash.h"
+
+#include "HytAnalysis.h"
+#include "HytMemory.h"
+#include "HytResults.h"
+#include "HytTrace.h"
+
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
 #include <queue>
+#include <set>
+#include <chrono>
+#include <memory>
 #include <stdint.h>
 
 using std::map;
@@ -26,100 +65,446 @@ using std::endl;
 using std::string;
 using std::vector;
 using std::queue;
+using std::set;
 using namespace llvm;
 
 
 
 #define DEBUG_TYPE "hytProgramAnalysis_PointerAnalysis"
-#define SHOW_INFO  //Show fact information and result. 
+
+STATISTIC(NumWorklistPushes, "Worklist pushes");
+STATISTIC(NumWorklistPops, "Worklist pops");
+STATISTIC(NumPropagatedBits, "Objects added to points-to sets");
+STATISTIC(NumFilteredBits, "Objects dropped by the type filter");
+STATISTIC(NumPFGEdges, "PFG edges added");
+STATISTIC(NumDispatchCalls, "Virtual calls dispatched");
+STATISTIC(NumBitVectorAllocs, "Bit vectors allocated");
+STATISTIC(NumMaterialized, "Function bodies loaded from lazy bitcode");
+
+// Timer regions, shown by -time-passes.
+static const char *const TimerGroupName = "hytPTA";
+static const char *const TimerGroupDesc = "Hyt Pointer Analysis";
+
+static cl::opt<string> CheckpointFile(
+    "hyt-pta-checkpoint", cl::value_desc("file"), cl::init(""),
+    cl::desc("Periodically snapshot the pointer analysis state to <file>"));
+static cl::opt<unsigned> CheckpointInterval(
+    "hyt-pta-checkpoint-interval", cl::value_desc("seconds"), cl::init(600),
+    cl::desc("Seconds between two pointer analysis snapshots"));
+static cl::opt<bool> ResumeFromCheckpoint(
+    "hyt-pta-resume", cl::init(false),
+    cl::desc("Resume pointer analysis from the -hyt-pta-checkpoint snapshot"));
+
+// Budgets, 0 means unlimited. When one is exceeded the solver stops and
+// collapses what is left (see CollapseRemaining()).
+static cl::opt<unsigned> TimeBudget(
+    "hyt-pta-time-budget", cl::value_desc("seconds"), cl::init(0),
+    cl::desc("Wall-clock budget of the pointer analysis solver"));
+static cl::opt<unsigned long long> IterationBudget(
+    "hyt-pta-iteration-budget", cl::value_desc("n"), cl::init(0),
+    cl::desc("Maximum number of worklist iterations of the pointer analysis solver"));
+static cl::opt<unsigned> MemoryBudget(
+    "hyt-pta-memory-budget", cl::value_desc("MB"), cl::init(0),
+    cl::desc("Heap budget of the pointer analysis solver"));
+enum CallGraphMode { PreciseCG, RTACG, RTAFilteredCG };
+static cl::opt<CallGraphMode> CGMode(
+    "hyt-pta-cg", cl::init(PreciseCG),
+    cl::desc("How the pointer analysis builds the call graph"),
+    cl::values(clEnumValN(PreciseCG, "precise", "Resolve calls with points-to sets only"),
+               clEnumValN(RTACG, "rta", "Stop after the rapid type analysis pre-pass"),
+               clEnumValN(RTAFilteredCG, "rta-filter",
+                          "Only consider methods and call sites the rapid type analysis reaches")));
+static cl::opt<bool> DevirtualizeCalls(
+    "hyt-pta-devirt", cl::init(false),
+    cl::desc("Rewrite virtual calls the pointer analysis resolved into direct calls"));
+static cl::opt<unsigned> DevirtMaxTargets(
+    "hyt-pta-devirt-max-targets", cl::init(3),
+    cl::desc("Most targets a virtual call may have to get guarded direct calls"));
+enum RootsMode { MainRoot, ExportedRoots, ExternalRoots, ListRoots };
+static cl::opt<RootsMode> Roots(
+    "hyt-pta-roots", cl::init(MainRoot),
+    cl::desc("Entry points the pointer analysis starts from"),
+    cl::values(clEnumValN(MainRoot, "main", "The main function"),
+               clEnumValN(ExportedRoots, "exported",
+                          "Every defined function with external linkage and default visibility"),
+               clEnumValN(ExternalRoots, "external", "Every defined function visible outside the module"),
+               clEnumValN(ListRoots, "list", "The functions named in -hyt-pta-roots-file")));
+static cl::opt<string> RootsFile(
+    "hyt-pta-roots-file", cl::value_desc("file"), cl::init(""),
+    cl::desc("Entry points of -hyt-pta-roots=list, one symbol per line"));
+static cl::opt<unsigned> Threads(
+    "hyt-pta-threads", cl::init(0),
+    cl::desc("Threads extracting the statements of methods before solving (0 = all cores)"));
+static cl::opt<string> ReportFile(
+    "hyt-pta-report", cl::value_desc("file"), cl::init(""),
+    cl::desc("Append the solver statistics of each run to <file> as one JSON line"));
+static cl::opt<bool> TypeFilter(
+    "hyt-pta-type-filter", cl::init(true),
+    cl::desc("Only propagate objects a pointer's declared class can hold"));
+static cl::opt<bool> ShowEscape(
+    "hyt-pta-escape", cl::init(false),
+    cl::desc("Print which objects escape their allocating method"));
+static cl::opt<bool> HeapToStack(
+    "hyt-pta-h2s", cl::init(false),
+    cl::desc("Turn `new` of objects that do not escape into stack allocations"));
+static cl::opt<unsigned> HeapToStackMaxSize(
+    "hyt-pta-h2s-max-size", cl::value_desc("bytes"), cl::init(1024),
+    cl::desc("Largest constant-size `new` turned into a stack allocation"));
+static cl::opt<bool> HeapToStackDynamic(
+    "hyt-pta-h2s-dynamic", cl::init(false),
+    cl::desc("Also turn `new` with a dynamic size into a dynamic stack allocation"));
+static cl::opt<unsigned> ProgressInterval(
+    "hyt-pta-progress", cl::value_desc("seconds"), cl::init(0),
+    cl::desc("Report pointer analysis progress every <seconds> (0 = never)"));
 
 namespace {
+  // Alias analysis answered from the points-to sets of the pointer analysis.
+  // Pointers are mapped to interned set ids, two pointers whose sets have no
+  // common object do not alias. Everything else goes down the AA chain.
+  class HytPTAAAResult : public AAResultBase<HytPTAAAResult> {
+    friend AAResultBase<HytPTAAAResult>;
+
+    // A deleted value drops out of the map, so an instruction created later
+    // at the same address does not inherit its set. A replaced value keeps
+    // its entry until it is deleted, the replacement gets none.
+    struct SetOfConfig : ValueMapConfig<const Value*> {
+      enum { FollowRAUW = false };
+    };
+    typedef ValueMap<const Value*, unsigned, SetOfConfig> SetOfMap;
+
+    vector<BitVector> sets_; // Interned points-to sets.
+    SetOfMap setOf_; // Underlying object of a pointer => set id.
+    DenseMap<pair<unsigned, unsigned>, bool> isDisjoint_; // Cache of set intersections.
+
+  public:
+    HytPTAAAResult(vector<BitVector> sets, const DenseMap<const Value*, unsigned> &setOf)
+        : sets_(std::move(sets)), setOf_(setOf.size()) {
+      for(const pair<const Value* const, unsigned> &it : setOf) {
+        setOf_[it.first] = it.second;
+      }
+    }
+
+    AliasResult alias(const MemoryLocation &LocA, const MemoryLocation &LocB,
+                      AAQueryInfo &AAQI) {
+      SetOfMap::iterator a = setOf_.find(getUnderlyingObject(LocA.Ptr));
+      SetOfMap::iterator b = setOf_.find(getUnderlyingObject(LocB.Ptr));
+      if(a != setOf_.end() && b != setOf_.end() && a->second != b->second) {
+        pair<unsigned, unsigned> key(std::min(a->second, b->second), std::max(a->second, b->second));
+        DenseMap<pair<unsigned, unsigned>, bool>::iterator cached = isDisjoint_.find(key);
+        if(cached == isDisjoint_.end()) {
+          cached = isDisjoint_.insert(pair<pair<unsigned, unsigned>, bool>(
+              key, !sets_[key.first].anyCommon(sets_[key.second]))).first;
+        }
+        if(cached->second) {
+          return AliasResult::NoAlias;
+        }
+      }
+      return AAResultBase::alias(LocA, LocB, AAQI);
+    }
+  };
+
+  // Keeps the alias results of the last pointer analysis run alive for the
+  // rest of the pipeline.
+  struct HytPTAAAWrapperPass : public ImmutablePass {
+    static char ID;
+    HytPTAAAWrapperPass() : ImmutablePass(ID) {}
+
+    std::unique_ptr<HytPTAAAResult> Result;
+  };
+
   // hytProgramAnalysis.
   struct hytProgramAnalysis : public ModulePass  { //public FunctionPass {
     static char ID; // Pass identification, replacement for typeid
     hytProgramAnalysis() : ModulePass(ID) {}
 
     map<Value*, size_t> Obj_; // mapping from Value obj to it position in bitvector.
-    size_t objCount_;
+    vector<Value*> objValue_; // Reverse of Obj_, position in bitvector to Value obj.
+    size_t objCount_ = 0; // Fixed by NumberAllocationSites() before solving.
 
     map<string, vector<string>> vTable_;
-    queue<pair<Value*, BitVector>> WL_; // Work List.
+    queue<pair<unsigned, BitVector>> WL_; // Work List of <node, pts>.
     vector<Function*> RM_; // Reachable method.
-    map<string, vector<pair<size_t, string>>> CG_; // Call Graph. E.g., FuncA -> <callSiteB, FuncB>, <callSiteC, FuncC>
-    map<Value*, BitVector>PT_; //PointerSet for each variable v (Value).
-    map< Value*, vector<Value*> > PFG_; //
+    DenseSet<Function*> RMSet_; // Same as RM_, for membership checks.
+    // Call Graph. E.g., FuncA -> <callSiteB, FuncB>, <callSiteC, FuncC>
+    // `cgEdges_` holds the same <callSite, callee> pairs for deduplication.
+    DenseMap<Function*, vector<pair<CallInst*, Function*>>> CG_;
+    DenseSet<pair<CallInst*, Function*>> cgEdges_;
+    // CG_ frozen into CSR form once solving ends, see FreezeCallGraph().
+    vector<Function*> cgNodes_;
+    vector<unsigned> cgOffsets_;
+    vector<pair<CallInst*, Function*>> cgCallees_;
+    std::unique_ptr<CallGraph> llvmCG_;
+    // PFG nodes are dense ids. A node is either a Value (variable, param,
+    // ...) or the field oi.f of an object, see NodeOf() and FieldNode().
+    vector<Value*> nodeValue_; // Node => Value, NULL for oi.f.
+    vector<pair<uint32_t, uint32_t>> nodeField_; // Node => <oi, f> for oi.f.
+    DenseMap<Value*, unsigned> valueNode_;
+    DenseMap<pair<uint32_t, uint32_t>, unsigned> fieldNode_;
+    // Fields are numbered by <class, element index>. The same object is
+    // accessed through the layout of each of its base classes, so the field
+    // of an object node is normalised to its allocated class, see ObjectField().
+    vector<pair<StructType*, unsigned>> fields_;
+    DenseMap<pair<StructType*, unsigned>, unsigned> fieldId_;
+    DenseMap<pair<StructType*, unsigned>, unsigned> objectField_; // <allocated class, f> => field.
+    const DataLayout *DL_ = NULL;
+    // Points-to sets alias queries may trust, see BuildAliasSets().
+    struct AliasSets {
+      vector<BitVector> sets; // Interned points-to sets.
+      DenseMap<const Value*, unsigned> setOf; // Underlying object of a pointer => set id.
+    };
+    Optional<AliasSets> aliasSets_; // Built on the first hyt::PointsTo query.
+    // Field loads and stores through each variable, see FieldAccessesOf().
+    struct FieldAccess {
+      unsigned field;
+      AllocaInst *y;
+      bool isLoad; // y = x.f if true, x.f = y otherwise.
+    };
+    DenseMap<AllocaInst*, vector<FieldAccess>> fieldAccesses_;
+    DenseSet<Function*> fieldsLoaded_; // Methods whose field accesses are in fieldAccesses_.
+
+    // Statements of one method, extracted once by ExtractConstraints() and
+    // consumed by AddReachable() when the method becomes reachable. They do
+    // not refer to solver state: operands index into `vars`, objects are
+    // object ids and fields index into `fields`.
+    struct Constraint {
+      enum Kind : uint8_t {
+        Copy,       // vars[dst] = vars[src]
+        New,        // vars[dst] = new T(), src is the object id.
+        LoadField,  // vars[dst] = vars[src].fields[field]
+        StoreField, // vars[dst].fields[field] = vars[src]
+        OpWarning,  // vars[dst] = vars[src] op ..., not supported.
+        NonNewWarning, // vars[dst] = vars[src], a value that is not new T().
+        MissedObj,  // vars[src] was not numbered by NumberAllocationSites().
+      } kind;
+      uint32_t dst;
+      uint32_t src;
+      uint32_t field;
+    };
+    struct FunctionConstraints {
+      vector<Value*> vars;
+      vector<pair<StructType*, unsigned>> fields;
+      vector<Constraint> constraints;
+    };
+    vector<FunctionConstraints> constraints_;
+    DenseMap<Function*, unsigned> constraintsOf_; // Method => index in constraints_.
+    vector<BitVector> PT_; // Node => points-to set.
+    // Solved PT_ grouped into equivalence classes, see CompressPointsTo().
+    vector<BitVector> ptClassSet_; // Class => points-to set.
+    vector<unsigned> ptClassOf_;   // Node => class.
+    vector< vector<unsigned> > PFG_; // Node => successors.
+
+    // Stable numbering of every Value in the module, so that a snapshot
+    // written by one process can be mapped back onto the IR by another one.
+    vector<Value*> idValue_;
+    DenseMap<Value*, uint32_t> valueId_;
+    std::chrono::steady_clock::time_point lastCheckpoint_;
+    // -hyt-pta-checkpoint of this module, see CheckpointPath().
+    string checkpointPath_;
+
+    // Solver progress, used by the progress report and the budgets.
+    std::chrono::steady_clock::time_point solveStart_;
+    std::chrono::steady_clock::time_point lastProgress_;
+    size_t edgeCount_ = 0;       // Number of PFG edges.
+    size_t propagatedBits_ = 0;  // Number of objects added to any PT_ entry.
+    size_t lastPropagatedBits_ = 0;
+    size_t worklistPops_ = 0;
+    double solveSeconds_ = 0;
+    bool budgetExceeded_ = false;
+
+    // Rapid type analysis pre-pass: conservative call graph built from the
+    // vtables that reachable constructors install.
+    vector<Function*> rtaRM_; // Reachable methods in discovery order.
+    DenseSet<Function*> rtaRMSet_;
+    DenseMap<CallInst*, vector<Function*>> rtaCallees_; // Call site => possible callees with a body.
+    // Whether M was opened with lazy function bodies. Only the bodies the
+    // RTA pre-pass reaches are loaded then, see Materialize().
+    bool lazy_ = false;
+    // Call sites of each reachable method, see CallSitesOf().
+    map<Function*, vector<CallInst*>> callSites_;
+
+    // Type filter: the class of each PFG node, and for each class the
+    // objects a pointer to that class may point to, see PushFiltered().
+    static const unsigned NoClass = ~0u;
+    DenseMap<StructType*, unsigned> classId_;
+    vector<BitVector> classMask_; // Class id => compatible objects.
+    vector<unsigned> nodeClass_; // Node => class id.
+    size_t filteredBits_ = 0; // Number of objects dropped by the filter.
+
+    // High-water mark of each structure per phase, see -hyt-mem-report.
+    hyt::MemoryLedger memory_;
+    std::chrono::steady_clock::time_point lastMemorySample_;
 
     void PrintObj() {
-      errs() << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Obj => idx\n" ;
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsFull)) {
+        for(map<Value*, size_t>::iterator obj = Obj_.begin(); obj != Obj_.end(); obj++) {
+          results.Label("object", obj->second, ConvertValueToString(obj->first));
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsFull);
+      OS << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Obj => idx\n" ;
       for(map<Value*, size_t>::iterator obj = Obj_.begin(); obj != Obj_.end(); obj++) {
-        errs() << "\t" << *(obj->first) << " => " << obj->second << "\n";
+        OS << "\t" << *(obj->first) << " => " << obj->second << "\n";
       }
     }
 
+    // Methods are numbered by their position in RM_, see PrintRM().
     void PrintCG() {
-      errs() << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Call Graph: caller => <callsite, callee>\n" ;
-      for(map<string, vector<pair<size_t, string>>>::iterator caller = CG_.begin(); caller != CG_.end(); caller++) {
-        errs() << "\t" << caller->first << " => ";
-        for(vector<pair<size_t, string>>::iterator callee = caller->second.begin(); callee != caller->second.end(); callee++) {
-          errs() << "<" << callee->first << ", " << callee->second << ">, ";
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsSummary)) {
+        DenseMap<Function*, unsigned> methodIdx;
+        for(Function *F : RM_) {
+          methodIdx.insert(pair<Function*, unsigned>(F, methodIdx.size()));
         }
-        errs() << "\n";
+        for(size_t caller = 0; caller + 1 < cgOffsets_.size(); caller++) {
+          for(unsigned idx = cgOffsets_[caller]; idx < cgOffsets_[caller + 1]; idx++) {
+            results.Edge("call", methodIdx.lookup(cgNodes_[caller]), methodIdx.lookup(cgCallees_[idx].second));
+          }
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsSummary);
+      OS << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Call Graph: caller => <callsite, callee>\n" ;
+      for(size_t caller = 0; caller + 1 < cgOffsets_.size(); caller++) {
+        if(cgOffsets_[caller] == cgOffsets_[caller + 1]) {
+          continue;
+        }
+        // Call sites are shown as the index of the call instruction in the caller.
+        DenseMap<Instruction*, size_t> callSiteIdx;
+        for (Function::iterator bb = cgNodes_[caller]->begin(); bb != cgNodes_[caller]->end(); ++bb) {
+          for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
+            callSiteIdx.insert(pair<Instruction*, size_t>(&*inst, callSiteIdx.size() + 1));
+          }
+        }
+        OS << "\t" << cgNodes_[caller]->getName() << " => ";
+        for(unsigned idx = cgOffsets_[caller]; idx < cgOffsets_[caller + 1]; idx++) {
+          OS << "<" << callSiteIdx[cgCallees_[idx].first] << ", " << cgCallees_[idx].second->getName() << ">, ";
+        }
+        OS << "\n";
       }
     }
 
     void PrintRM() {
-      errs() << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Reachable Method: \n" ;
-      errs() << "\t" ;
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsSummary)) {
+        for(unsigned idx = 0; idx < RM_.size(); idx++) {
+          results.Label("method", idx, RM_[idx]->getName());
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsSummary);
+      OS << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Reachable Method: \n" ;
+      OS << "\t" ;
       for(Function *F : RM_) {
-        errs() << F->getName() << ", ";
+        OS << F->getName() << ", ";
+      }
+      OS << "\n";
+    }
+
+    // Print a node, oi.f is shown as `<oi>.<class>::<element index>`.
+    void PrintNode(raw_ostream &OS, unsigned n) {
+      if(nodeValue_[n]) {
+        OS << *nodeValue_[n];
+        return;
       }
-      errs() << "\n";
+      pair<StructType*, unsigned> &field = fields_[nodeField_[n].second];
+      OS << *objValue_[nodeField_[n].first] << "." << field.first->getName() << "::" << field.second;
     }
 
+    // Print each distinct points-to set once, then the class of each node.
     void PrintPT() {
-      errs() << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Pointer Set: \n" ;
-      for(map<Value*, BitVector>::iterator it = PT_.begin(); it != PT_.end(); it++) {
-        errs() << "\t" <<*(it->first) << " : ";
-        PrintBitVector(it->second);
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsFull)) {
+        for(unsigned cls = 0; cls < ptClassSet_.size(); cls++) {
+          results.Set("class", cls, ptClassSet_[cls]);
+        }
+        for(unsigned n = 0; n < ptClassOf_.size(); n++) {
+          string text;
+          raw_string_ostream OS(text);
+          PrintNode(OS, n);
+          results.Label("node", n, OS.str());
+          results.Edge("points_to", n, ptClassOf_[n]);
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsFull);
+      OS << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Pointer Set: class => obj\n" ;
+      for(unsigned cls = 0; cls < ptClassSet_.size(); cls++) {
+        OS << "\t" << cls << " : ";
+        PrintBitVector(ptClassSet_[cls]);
+      }
+      OS << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Pointer => class\n" ;
+      for(unsigned n = 0; n < ptClassOf_.size(); n++) {
+        OS << "\t";
+        PrintNode(OS, n);
+        OS << " : " << ptClassOf_[n] << "\n";
       }
     }
 
     void PrintPFG() {
-      errs() << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " PFG: obj => obj \n" ;
-      for(map< Value*, vector<Value*> >::iterator source = PFG_.begin(); source != PFG_.end(); source++) {
-        errs() << "\t" <<*(source->first) << " => ";
-        for(vector<Value*>::iterator target = source->second.begin(); target != source->second.end(); target++) {
-          errs() << *(*target) << ", " ;
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsFull)) {
+        for(unsigned source = 0; source < PFG_.size(); source++) {
+          for(unsigned target : PFG_[source]) {
+            results.Edge("pfg", source, target);
+          }
         }
-        errs() << "\n";
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsFull);
+      OS << "  \t[" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " PFG: obj => obj \n" ;
+      for(unsigned source = 0; source < PFG_.size(); source++) {
+        if(PFG_[source].empty()) {
+          continue;
+        }
+        OS << "\t";
+        PrintNode(OS, source);
+        OS << " => ";
+        for(unsigned target : PFG_[source]) {
+          PrintNode(OS, target);
+          OS << ", " ;
+        }
+        OS << "\n";
       }
     }
 
-    void PrintVTable(map<string, vector<string>> vTable) {
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " vTable => Contents:\n" ;
-      for(map<string, vector<string>>::iterator it = vTable.begin();
+    void PrintVTable(const map<string, vector<string>> &vTable) {
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsFull)) {
+        unsigned idx = 0;
+        for(const pair<const string, vector<string>> &it : vTable) {
+          results.Label("vtable", idx++, it.first + " => " + join(it.second, ", "));
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsFull);
+      OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " vTable => Contents:\n" ;
+      for(map<string, vector<string>>::const_iterator it = vTable.begin();
           it != vTable.end(); it++) {
-            errs() << (it->first) << " => ";
-            for(vector<string>::iterator i = it->second.begin(); i != it->second.end(); i++) {
-              errs() << *i << ", ";
+            OS << (it->first) << " => ";
+            for(vector<string>::const_iterator i = it->second.begin(); i != it->second.end(); i++) {
+              OS << *i << ", ";
             }
-            errs() << "\n";
+            OS << "\n";
         
       }
     }
 
 
-    void PrintBitVector(BitVector bit_vector) {
-      for(int i = 0; i < bit_vector.size(); i++) {
-        errs() << bit_vector[i] << " ";
+    void PrintBitVector(const BitVector &bit_vector) {
+      raw_ostream &OS = hyt::Results().Text(hyt::ResultsFull);
+      for(unsigned i = 0; i < bit_vector.size(); i++) {
+        OS << (bit_vector[i] ? "1 " : "0 ");
       }
-      errs() << "\n";
+      OS << "\n";
     }
 
     // res = a - b, where 1-1 = 0, 0-1 = 0. 0-0 = 0, 1-0 = 1
@@ -164,7 +549,9 @@ namespace {
         inst = dyn_cast<Instruction>(v);
         opcodeName = inst->getOpcodeName();
         if(opcodeName == "getelementptr") {
-          offset = std::stoi(inst->getOperand(1)->getNameOrAsOperand()); // Get the function offset in vtable.
+          if(ConstantInt *idx = dyn_cast<ConstantInt>(inst->getOperand(1))) {
+            offset = idx->getSExtValue(); // Get the function offset in vtable.
+          }
         }
       }while(!(opcodeName == "alloca"));
 
@@ -205,6 +592,8 @@ namespace {
 
     // Dispatch a indirect call.
     string Dispatch(Value *x, Value *oi, Instruction *indirctCall) {
+      TimeTraceScope trace("Dispatch");
+      ++NumDispatchCalls;
       Function *F;
       int offset; // Function offset in vtable.
       Value *obj = FindMethodCallObj(indirctCall, offset); // Find the obj that contains this indirect call
@@ -267,55 +656,247 @@ namespace {
       
     }
 
-    // AddEdge from s to t.
-    void AddEdge(Value *s, Value *t) {
-      bool isExist = false;
-      if(PFG_.find(s) == PFG_.end()) { // No s -> t, because there is no edges that coming out from s.
-        vector<Value*> tmp;
-        tmp.push_back(t);
-        PFG_.insert( pair<Value*, vector<Value*>>(s, tmp) );
-        if(PT_.find(s) == PT_.end()) {
-          BitVector tmp = BitVector(objCount_, false);
-          PT_.insert(pair<Value*, BitVector>(s, tmp));
-        }
-      } else { // There exist edges that coming out from s.
-        // Find if exist s -> t.
-        for(size_t idx = 0; idx < PFG_[s].size(); idx++) {
-          if(PFG_[s][idx] == t) {
-            isExist = true;
-            break;
+    // Find the field a getelementptr 0, i, ..., k addresses, i.e. element k
+    // of the innermost class the constant indices step into.
+    /// @return true if gep addresses a field of a class.
+    bool FieldOfGEP(GetElementPtrInst *gep, pair<StructType*, unsigned> &field) {
+      ConstantInt *first = dyn_cast<ConstantInt>(gep->getOperand(1));
+      if(gep->getNumOperands() < 3 || !first || !first->isZero()) {
+        return false;
+      }
+      StructType *ST = PointeeClass(gep->getPointerOperandType());
+      for(unsigned op = 2; ST && op < gep->getNumOperands(); op++) {
+        ConstantInt *idx = dyn_cast<ConstantInt>(gep->getOperand(op));
+        if(!idx || idx->getZExtValue() >= ST->getNumElements()) {
+          return false;
+        }
+        field = pair<StructType*, unsigned>(ST, idx->getZExtValue());
+        ST = op + 1 < gep->getNumOperands() ? dyn_cast<StructType>(ST->getElementType(field.second)) : ST;
+      }
+      return ST != NULL;
+    }
+
+    // @return the class T points to, or NULL if T is not a class pointer.
+    StructType* PointeeClass(Type *T) {
+      if(!T->isPointerTy()) {
+        return NULL;
+      }
+      StructType *ST = dyn_cast<StructType>(T->getPointerElementType());
+      if(!ST || !ST->hasName() || !ST->getName().startswith("class.")) {
+        return NULL;
+      }
+      return ST;
+    }
+
+    // @return true if an object of class outer contains a subobject of
+    // class inner, e.g. its base class. Members count too, which only
+    // makes the filter more permissive.
+    bool Embeds(Type *outer, StructType *inner) {
+      if(outer == inner) {
+        return true;
+      }
+      if(ArrayType *AT = dyn_cast<ArrayType>(outer)) {
+        return Embeds(AT->getElementType(), inner);
+      }
+      if(StructType *ST = dyn_cast<StructType>(outer)) {
+        for(Type *element : ST->elements()) {
+          if(Embeds(element, inner)) {
+            return true;
           }
         }
-        if(!isExist) { // No s -> t
-          PFG_[s].push_back(t);
+      }
+      return false;
+    }
+
+    // Intern a class and compute the objects a pointer to it may point to.
+    // Objects that are not of a class type are always kept.
+    unsigned InternClass(StructType *ST) {
+      DenseMap<StructType*, unsigned>::iterator it = classId_.find(ST);
+      if(it != classId_.end()) {
+        return it->second;
+      }
+      BitVector mask(objCount_, false);
+      for(size_t idx = 0; idx < objCount_; idx++) {
+        StructType *objClass = PointeeClass(objValue_[idx]->getType());
+        if(!objClass || Embeds(objClass, ST)) {
+          mask.set(idx);
         }
       }
+      classMask_.push_back(mask);
+      classId_.insert(pair<StructType*, unsigned>(ST, classMask_.size() - 1));
+      return classMask_.size() - 1;
+    }
 
-      if(!isExist && (PT_[s].any())) { // If no s->t is set before, and pt(s) is not empty.
-        if(PT_[s].size() < objCount_) { // Resize BitVector at everytime we using it.
-          PT_[s].resize(objCount_);
+    // @return the class id of the pointer held by Value node n, or
+    // NoClass when n is not filtered.
+    unsigned ValueClass(Value *n) {
+      StructType *ST = NULL;
+      if(AllocaInst *x = dyn_cast<AllocaInst>(n)) { // Variable, or the mthis/return slot.
+        ST = PointeeClass(x->getAllocatedType());
+      } else if(isa<Argument>(n)) { // Param.
+        ST = PointeeClass(n->getType());
+      }
+      return ST ? InternClass(ST) : NoClass;
+    }
+
+    // @return the node of Value v, allocated on first use.
+    unsigned NodeOf(Value *v) {
+      DenseMap<Value*, unsigned>::iterator it = valueNode_.find(v);
+      if(it != valueNode_.end()) {
+        return it->second;
+      }
+      unsigned n = nodeValue_.size();
+      valueNode_.insert(pair<Value*, unsigned>(v, n));
+      nodeValue_.push_back(v);
+      nodeField_.push_back(pair<uint32_t, uint32_t>(0, 0));
+      nodeClass_.push_back(ValueClass(v));
+      PT_.push_back(BitVector(objCount_, false));
+      PFG_.push_back(vector<unsigned>());
+      return n;
+    }
+
+    // @return the id of element `idx` of class ST.
+    unsigned FieldId(StructType *ST, unsigned idx) {
+      pair<StructType*, unsigned> field(ST, idx);
+      DenseMap<pair<StructType*, unsigned>, unsigned>::iterator it = fieldId_.find(field);
+      if(it != fieldId_.end()) {
+        return it->second;
+      }
+      fields_.push_back(field);
+      fieldId_.insert(pair<pair<StructType*, unsigned>, unsigned>(field, fields_.size() - 1));
+      return fields_.size() - 1;
+    }
+
+    // A field f accessed through a base class of object oi is the element of
+    // the allocated class of oi at the same offset: walk the embedding chain
+    // from the allocated class down to the element that has the type of f.
+    // A base class cast is a no-op, so f is at its offset within the base.
+    /// @return the field of oi that f addresses.
+    unsigned ObjectField(uint32_t oi, unsigned f) {
+      StructType *outer = PointeeClass(objValue_[oi]->getType());
+      StructType *ST = fields_[f].first;
+      if(!outer || outer == ST || !outer->isSized() || !ST->isSized()) {
+        return f;
+      }
+      pair<StructType*, unsigned> key(outer, f);
+      DenseMap<pair<StructType*, unsigned>, unsigned>::iterator it = objectField_.find(key);
+      if(it != objectField_.end()) {
+        return it->second;
+      }
+      Type *target = ST->getElementType(fields_[f].second);
+      uint64_t offset = DL_->getStructLayout(ST)->getElementOffset(fields_[f].second);
+      unsigned field = f;
+      StructType *cur = outer;
+      while(cur && offset < DL_->getTypeAllocSize(cur)) {
+        const StructLayout *layout = DL_->getStructLayout(cur);
+        unsigned idx = layout->getElementContainingOffset(offset);
+        Type *element = cur->getElementType(idx);
+        offset -= layout->getElementOffset(idx);
+        if(offset == 0 && element == target) {
+          field = FieldId(cur, idx);
+          break;
+        }
+        cur = dyn_cast<StructType>(element);
+      }
+      objectField_.insert(pair<pair<StructType*, unsigned>, unsigned>(key, field));
+      return field;
+    }
+
+    // @return the node of oi.f, allocated on first use.
+    unsigned FieldNode(uint32_t oi, uint32_t f) {
+      pair<uint32_t, uint32_t> key(oi, f);
+      DenseMap<pair<uint32_t, uint32_t>, unsigned>::iterator it = fieldNode_.find(key);
+      if(it != fieldNode_.end()) {
+        return it->second;
+      }
+      unsigned n = nodeValue_.size();
+      fieldNode_.insert(pair<pair<uint32_t, uint32_t>, unsigned>(key, n));
+      nodeValue_.push_back(NULL);
+      nodeField_.push_back(key);
+      StructType *ST = PointeeClass(fields_[f].first->getElementType(fields_[f].second));
+      nodeClass_.push_back(ST ? InternClass(ST) : NoClass);
+      PT_.push_back(BitVector(objCount_, false));
+      PFG_.push_back(vector<unsigned>());
+      return n;
+    }
+
+    // @return the points-to set of v, or NULL if v is not a PFG node.
+    const BitVector* PointsToSetOf(Value *v) {
+      DenseMap<Value*, unsigned>::iterator it = valueNode_.find(v);
+      return it == valueNode_.end() ? NULL : &PT_[it->second];
+    }
+
+    // add <t, pts> to WL, without the objects the class of t cannot hold.
+    void PushFiltered(unsigned t, const BitVector &pts) {
+      unsigned cls = TypeFilter ? nodeClass_[t] : NoClass;
+      if(cls == NoClass) {
+        WL_.push(pair<unsigned, BitVector>(t, pts));
+        ++NumWorklistPushes;
+        return;
+      }
+      BitVector filtered = pts;
+      ++NumBitVectorAllocs;
+      filtered &= classMask_[cls];
+      size_t kept = filtered.count();
+      filteredBits_ += pts.count() - kept;
+      NumFilteredBits += pts.count() - kept;
+      if(kept) {
+        WL_.push(pair<unsigned, BitVector>(t, filtered));
+        ++NumWorklistPushes;
+      }
+    }
+
+    // AddEdge from s to t.
+    void AddEdge(unsigned s, unsigned t) {
+      bool isExist = false;
+      // Find if exist s -> t.
+      for(size_t idx = 0; idx < PFG_[s].size(); idx++) {
+        if(PFG_[s][idx] == t) {
+          isExist = true;
+          break;
         }
-        WL_.push(pair<Value*, BitVector>(t, PT_[s])); // add <t, pt(s)> to WL.
+      }
+      if(!isExist) { // No s -> t
+        PFG_[s].push_back(t);
+        edgeCount_++;
+        ++NumPFGEdges;
+      }
+
+      if(!isExist && (PT_[s].any())) { // If no s->t is set before, and pt(s) is not empty.
+        PushFiltered(t, PT_[s]); // add <t, pt(s)> to WL.
       }
     }
 
     // Propagate the pointer set.
-    void Propagate(Value *n, BitVector pts) {
+    void Propagate(unsigned n, BitVector pts) {
+      TimeTraceScope trace("Propagate");
       if(pts.any()) { // If not empty.
-        if(pts.size() < PT_[n].size()) {
-          pts.resize(PT_[n].size());
-        } else if (pts.size() < PT_[n].size()) {
-          PT_[n].resize(pts.size());
-        }
         PT_[n] |= pts;
+        propagatedBits_ += pts.count();
+        NumPropagatedBits += pts.count();
 
-        if(PFG_.find(n) != PFG_.end()) {
-          // for(size_t idx; idx < PFG_[n].size(); idx++) { 
-          for(Value *s : PFG_[n]) { // Foreach n -> s in PFG.
-            WL_.push(pair<Value*, BitVector>(s, pts)); // add <s, pts> to WL.
+        for(unsigned s : PFG_[n]) { // Foreach n -> s in PFG.
+          PushFiltered(s, pts); // add <s, pts> to WL.
+        }
+      }
+    }
+
+    // @return the field loads and stores through variable x, from the
+    // LoadField/StoreField constraints of its method.
+    vector<FieldAccess>& FieldAccessesOf(AllocaInst *x) {
+      Function *F = x->getFunction();
+      if(fieldsLoaded_.insert(F).second) {
+        FunctionConstraints &FC = ConstraintsOf(F);
+        for(Constraint &c : FC.constraints) {
+          if(c.kind == Constraint::LoadField || c.kind == Constraint::StoreField) {
+            AllocaInst *var = dyn_cast<AllocaInst>(c.kind == Constraint::LoadField ? FC.vars[c.src] : FC.vars[c.dst]);
+            AllocaInst *y = dyn_cast<AllocaInst>(c.kind == Constraint::LoadField ? FC.vars[c.dst] : FC.vars[c.src]);
+            unsigned field = FieldId(FC.fields[c.field].first, FC.fields[c.field].second);
+            fieldAccesses_[var].push_back(FieldAccess{field, y, c.kind == Constraint::LoadField});
           }
         }
       }
+      return fieldAccesses_[x];
     }
 
     // void FindVaraiable(Value *v) {
@@ -327,120 +908,265 @@ namespace {
     //   errs() << "User: " << *U << "\n";
     // }
 
-    // 
-    void AddReachable(Function *F) {
-      bool isReachable = false;
-      for(size_t idx = 0; idx < RM_.size(); idx++) {
-        if(RM_[idx] == F) {
-          isReachable = true;
-          break;
+    // Find the object created by x = new T(), i.e. the value right after the
+    // `new` call, e.g. %0 = bitcast i8* %call to %class.T*.
+    /// @param rightV, the value stored into x.
+    /// @return obj, or NULL if rightV does not come from a call.
+    Value* FindNewObj(Value *rightV) {
+      SmallPtrSet<Value*, 8> visited;
+      Value *obj = rightV;
+      while(Instruction *inst = dyn_cast<Instruction>(obj)) {
+        if(inst->getNumOperands() == 0 || !visited.insert(obj).second) {
+          return NULL;
         }
+        if(dyn_cast<CallInst>(inst->getOperand(0))) {
+          return obj;
+        }
+        obj = inst->getOperand(0);
+      }
+      return NULL;
+    }
+
+    // @return the object if `store` is x = new T(), otherwise NULL.
+    // It accepts exactly the stores AddReachable() treats as x = new T().
+    Value* AllocationSite(StoreInst *store) {
+      AllocaInst *leftV = dyn_cast<AllocaInst>(store->getOperand(1));
+      Instruction *rightInst = dyn_cast<Instruction>(store->getOperand(0));
+      if(!leftV || !rightInst || !leftV->getAllocatedType()->isPointerTy()) {
+        return NULL;
       }
+      if(dyn_cast<LoadInst>(rightInst) || dyn_cast<CallInst>(rightInst) ||
+         rightInst->isUnaryOp() || rightInst->isBinaryOp() ||
+         rightInst->isShift() || rightInst->isBitwiseLogicOp()) {
+        return NULL;
+      }
+      return FindNewObj(rightInst);
+    }
 
-      if(!isReachable) {
-        // errs() << "Add reachable to func really: " << F->getName() << "\n"; 
-        RM_.push_back(F);
-        for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {        
+    // Number every allocation site of every defined function before solving,
+    // so `objCount_` is final and points-to sets are allocated once at their
+    // final width instead of being resized while the solver runs.
+    void NumberAllocationSites(Module &M) {
+      for (Function &F : M) {
+        if(CGMode == RTAFilteredCG && !rtaRMSet_.count(&F)) { // Never reachable.
+          continue;
+        }
+        for (Function::iterator bb = F.begin(); bb != F.end(); ++bb) {
           for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-            string opcodeName = inst->getOpcodeName();
-            if(opcodeName == "store") { // It has already contains x = new T(), and x = y.
-              Value *leftV = inst->getOperand(1);
-              Value *rightV = inst->getOperand(0);
-              //string leftOperandName = dyn_cast<Instruction>(leftV)->getOpcodeName(); 
-              // If the second operand is alloca, than it is a assign operation.
-              // errs() << "left: " << *leftV << "\n";
-              // errs() << "right: " << *rightV << "\n";
-              //if(leftOperandName == "alloca" && dyn_cast<Instruction>(rightV)) { 
-              if(dyn_cast<AllocaInst>(leftV) && dyn_cast<Instruction>(rightV)) { // Find assign leftV = rightV, where rightV is not a constant.
-                // errs() << "process obj assign thing.\n";
-                if(ConvertValueToString(leftV).find("*,") != string::npos) { // If leftV is a pointer obj.
-                  // errs() << "It is a assign to an obj.\n";
-                  if(LoadInst *ldinst = dyn_cast<LoadInst>(rightV)) { // case: x = y or x = z.foo(); i.e., %tmp = load y; store %tmp, x;
-                    // errs() << "\t case: x = y \n";
-                    //string opcodeName = dyn_cast<Instruction>(ldinst->getOperand(0))->getOpcodeName();
-                    //if(opcodeName == "alloc") { 
-                    if(dyn_cast<AllocaInst>(ldinst->getOperand(0))) { // case: x = y, instead of x = z.foo();
-                      // errs() << "Add edge: " << *rightV << " => " << *leftV << "\n";
-                      // AddEdge(rightV, leftV);
-                      AddEdge(ldinst->getOperand(0), leftV);
-                    } 
-  
-                  } else {  // With bug ///////////////////////////////
-                    if( Instruction *rightInst = dyn_cast<Instruction>(rightV)) {
-                      if(rightInst->isUnaryOp()  || // If it is Unary Operations.
-                        rightInst->isBinaryOp() || // If it is Binary Ops.
-                        rightInst->isShift()    || // If it is Shift Ops.
-                        rightInst->isBitwiseLogicOp()) {
-                        /// TODO: when it comes to objA = objB + objC; where + operator is override by class.
-                        errs() << "[Warning] Now not support analysis for objA = objB op objC. The inst is: " 
-                              << *leftV << " '=' " << *rightV << "\n";
-                      } else if (!dyn_cast<CallInst>(rightV)) { // case: x = new T();, not a call like x = a.foo();
-                        // errs() << "\t case: x = new T() \n";
-                        // Confirm obj.
-                        Value *obj = rightV;
-                        while(!dyn_cast<CallInst>(dyn_cast<Instruction>(obj)->getOperand(0))) {
-                          obj = dyn_cast<Instruction>(obj)->getOperand(0);
-                        }
-
-                        if(Obj_.find(obj) == Obj_.end()) {
-                          Obj_.insert(pair<Value*, size_t>(obj, objCount_++));
-                        }
-                        BitVector tmp = BitVector(objCount_, false);
-                        tmp[Obj_[obj]] = true;
-                        
-                        // Confirm x.
-                        Value *x = NULL;
-                        for(User *U : rightV->users()) {
-                          if(StoreInst *store = dyn_cast<StoreInst>(U)) {
-                            x = store->getOperand(1);
-                            if(dyn_cast<AllocaInst>(x)) {
-                              break;
-                            } else {
-                              x = NULL;
-                            }
-                          }
-                        }
-                        // WL_.push(pair<Value*, BitVector>(rightV, tmp));
-                        WL_.push(pair<Value*, BitVector>(x, tmp));
-                        // errs() << "Add WL: " << *x << " => " << *rightV << "\n";
-                      } else {
-                        if(dyn_cast<CallInst>(rightV)) { // When there is x = a.foo(); Skip it, because we will handle this when perform ProcessCall.
-                          continue;
-                        }
-                        /// TODO: when it comes to int *p; int a = 0; p = &a;
-                        errs() << "[Warning] Now not support analysis for int *p; int a = 0; p = &a;. The inst is: " 
-                              << *leftV << " '=' " << *rightV << "\n";
-                      }
-                        
-                    } 
-                    
-                  }
+            if(StoreInst *store = dyn_cast<StoreInst>(inst)) {
+              Value *obj = AllocationSite(store);
+              if(obj && Obj_.find(obj) == Obj_.end()) {
+                Obj_.insert(pair<Value*, size_t>(obj, objCount_++));
+                objValue_.push_back(obj);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // Extract the statements of F. Only reads the IR and Obj_, so it runs
+    // on many methods at once, see ExtractAllConstraints().
+    void ExtractConstraints(Function *F, FunctionConstraints &FC) {
+      TimeTraceScope trace("ExtractConstraints", F->getName());
+      DenseMap<Value*, uint32_t> varIdx;
+      auto Var = [&](Value *v) -> uint32_t {
+        std::pair<DenseMap<Value*, uint32_t>::iterator, bool> it = varIdx.insert(pair<Value*, uint32_t>(v, FC.vars.size()));
+        if(it.second) {
+          FC.vars.push_back(v);
+        }
+        return it.first->second;
+      };
+      auto Add = [&](Constraint::Kind kind, Value *dst, Value *src, uint32_t field) {
+        FC.constraints.push_back(Constraint{kind, Var(dst), src ? Var(src) : 0, field});
+      };
+
+      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
+        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
+          StoreInst *store = dyn_cast<StoreInst>(inst);
+          if(!store) { // x = new T(), and x = y are stores.
+            continue;
+          }
+          AllocaInst *leftV = dyn_cast<AllocaInst>(store->getPointerOperand());
+          Instruction *rightInst = dyn_cast<Instruction>(store->getValueOperand());
+          // Find assign leftV = rightV, where rightV is not a constant and leftV is a pointer obj.
+          if(!leftV || !rightInst || !leftV->getAllocatedType()->isPointerTy()) {
+            continue;
+          }
+          if(LoadInst *ldinst = dyn_cast<LoadInst>(rightInst)) { // case: x = y or x = z.foo(); i.e., %tmp = load y; store %tmp, x;
+            if(isa<AllocaInst>(ldinst->getPointerOperand())) { // case: x = y, instead of x = z.foo();
+              Add(Constraint::Copy, leftV, ldinst->getPointerOperand(), 0);
+            }
+          } else if(rightInst->isUnaryOp() || rightInst->isBinaryOp() ||
+                    rightInst->isShift() || rightInst->isBitwiseLogicOp()) {
+            /// TODO: when it comes to objA = objB + objC; where + operator is override by class.
+            Add(Constraint::OpWarning, leftV, rightInst, 0);
+          } else if(!isa<CallInst>(rightInst)) { // case: x = new T();, not a call like x = a.foo();
+            // x = a.foo(); is handled when perform ProcessCall.
+            Value *obj = FindNewObj(rightInst);
+            if(!obj) {
+              Add(Constraint::NonNewWarning, leftV, rightInst, 0);
+              continue;
+            }
+            map<Value*, size_t>::const_iterator found = Obj_.find(obj);
+            if(found == Obj_.end()) { // Every allocation site is numbered by NumberAllocationSites().
+              Add(Constraint::MissedObj, leftV, obj, 0);
+              continue;
+            }
+            // Confirm x.
+            Value *x = NULL;
+            for(User *U : rightInst->users()) {
+              if(StoreInst *xStore = dyn_cast<StoreInst>(U)) {
+                x = xStore->getPointerOperand();
+                if(isa<AllocaInst>(x)) {
+                  break;
                 }
+                x = NULL;
               }
-            } 
-            
-            /*else if (opcodeName == "call") {
-              errs() << *inst << "\n";
-              // string calledFunc = dyn_cast<CallInst>(inst)->getCalledFunction()->getName().data();
-              // if(calledFunc == "_Znwm") { // If it is a new operation.
-                
-              //   Value *v = dyn_cast<Value>(inst);
-              //   errs() << *v << "\n";
-              // }
-              string calledFunc = ConvertValueToString(dyn_cast<Value>(inst));
-              // errs() << calledFunc << "\n";
-              if(calledFunc.find("_Znwm") != string::npos) {
-                errs() << "it is new: " << calledFunc << "\n";
-                /// TODO: add something to WL_
-                FindVaraiable(dyn_cast<Value>(inst));
+            }
+            FC.constraints.push_back(Constraint{Constraint::New, Var(x), (uint32_t)found->second, 0});
+          }
+        }
+      }
+
+      // Field loads and stores through each variable x, i.e.
+      //   y = x.f: %p = load x; %f = getelementptr %p, 0, k; %v = load %f; store %v, y
+      //   x.f = y: %p = load x; %f = getelementptr %p, 0, k; %v = load y; store %v, %f
+      // %p may be cast to a base class first, and the getelementptr may step
+      // into base subobjects, e.g. getelementptr %p, 0, 0, k.
+      DenseMap<pair<StructType*, unsigned>, uint32_t> fieldIdx;
+      for (inst_iterator inst = inst_begin(F); inst != inst_end(F); ++inst) {
+        AllocaInst *x = dyn_cast<AllocaInst>(&*inst);
+        if(!x) {
+          continue;
+        }
+        for(User *XU : x->users()) {
+          LoadInst *base = dyn_cast<LoadInst>(XU);
+          if(!base) {
+            continue;
+          }
+          SmallVector<GetElementPtrInst*, 8> geps;
+          for(User *BU : base->users()) {
+            if(GetElementPtrInst *gep = dyn_cast<GetElementPtrInst>(BU)) {
+              geps.push_back(gep);
+            } else if(BitCastInst *cast = dyn_cast<BitCastInst>(BU)) {
+              for(User *CU : cast->users()) {
+                if(GetElementPtrInst *gep = dyn_cast<GetElementPtrInst>(CU)) {
+                  geps.push_back(gep);
+                }
+              }
+            }
+          }
+          for(GetElementPtrInst *gep : geps) {
+            pair<StructType*, unsigned> key;
+            if(!FieldOfGEP(gep, key)) {
+              continue;
+            }
+            std::pair<DenseMap<pair<StructType*, unsigned>, uint32_t>::iterator, bool> field =
+                fieldIdx.insert(pair<pair<StructType*, unsigned>, uint32_t>(key, FC.fields.size()));
+            if(field.second) {
+              FC.fields.push_back(key);
+            }
+            for(User *GU : gep->users()) {
+              if(LoadInst *load = dyn_cast<LoadInst>(GU)) { // Maybe y = x.f
+                for(User *LU : load->users()) {
+                  StoreInst *store = dyn_cast<StoreInst>(LU);
+                  AllocaInst *y = store ? dyn_cast<AllocaInst>(store->getPointerOperand()) : NULL;
+                  if(y && store->getValueOperand() == load) {
+                    Add(Constraint::LoadField, y, x, field.first->second);
+                  }
+                }
+              } else if(StoreInst *store = dyn_cast<StoreInst>(GU)) { // Maybe x.f = y
+                LoadInst *load = dyn_cast<LoadInst>(store->getValueOperand());
+                AllocaInst *y = load ? dyn_cast<AllocaInst>(load->getPointerOperand()) : NULL;
+                if(y && store->getPointerOperand() == gep) {
+                  Add(Constraint::StoreField, x, y, field.first->second);
+                }
               }
             }
-            */
           }
         }
       }
-      // string funcName = F->getName().data();
-      // errs() << "current func name: " << funcName << "\n";
+    }
+
+    // Extract the statements of every method that may become reachable on
+    // a thread pool, before solving.
+    void ExtractAllConstraints(Module &M) {
+      TimeTraceScope trace("ExtractAllConstraints");
+      vector<Function*> funcs;
+      for (Function &F : M) {
+        if(F.isDeclaration() || F.isMaterializable() || (CGMode == RTAFilteredCG && !rtaRMSet_.count(&F))) {
+          continue;
+        }
+        constraintsOf_.insert(pair<Function*, unsigned>(&F, funcs.size()));
+        funcs.push_back(&F);
+      }
+      constraints_.resize(funcs.size());
+
+      const size_t chunk = 64;
+      ThreadPool pool(hardware_concurrency(Threads));
+      bool tracing = timeTraceProfilerEnabled();
+      for(size_t begin = 0; begin < funcs.size(); begin += chunk) {
+        size_t end = std::min(begin + chunk, funcs.size());
+        pool.async([this, &funcs, begin, end, tracing] {
+          hyt::TimeTraceThread traceThread(tracing);
+          for(size_t idx = begin; idx < end; idx++) {
+            ExtractConstraints(funcs[idx], constraints_[idx]);
+          }
+        });
+      }
+      pool.wait();
+    }
+
+    // @return the statements of F, extracted now if the parallel phase
+    // did not cover F.
+    FunctionConstraints& ConstraintsOf(Function *F) {
+      DenseMap<Function*, unsigned>::iterator it = constraintsOf_.find(F);
+      if(it != constraintsOf_.end()) {
+        return constraints_[it->second];
+      }
+      constraintsOf_.insert(pair<Function*, unsigned>(F, constraints_.size()));
+      constraints_.push_back(FunctionConstraints());
+      ExtractConstraints(F, constraints_.back());
+      return constraints_.back();
+    }
+
+    // Add F to RM_, and its x = y and x = new T() statements to the PFG and WL.
+    void AddReachable(Function *F) {
+      if(!RMSet_.insert(F).second) {
+        return;
+      }
+      TimeTraceScope trace("AddReachable", F->getName());
+      RM_.push_back(F);
+      FunctionConstraints &FC = ConstraintsOf(F);
+      for(Constraint &c : FC.constraints) {
+        switch(c.kind) {
+          case Constraint::Copy:
+            AddEdge(NodeOf(FC.vars[c.src]), NodeOf(FC.vars[c.dst]));
+            break;
+          case Constraint::New: {
+            BitVector tmp = BitVector(objCount_, false);
+            tmp[c.src] = true;
+            WL_.push(pair<unsigned, BitVector>(NodeOf(FC.vars[c.dst]), tmp));
+            ++NumWorklistPushes;
+            ++NumBitVectorAllocs;
+            break;
+          }
+          case Constraint::OpWarning:
+            errs() << "[Warning] Now not support analysis for objA = objB op objC. The inst is: " 
+                   << *FC.vars[c.dst] << " '=' " << *FC.vars[c.src] << "\n";
+            break;
+          case Constraint::NonNewWarning:
+            errs() << "[Warning] Now not support analysis for x = non-new value. The inst is: "
+                   << *FC.vars[c.dst] << " '=' " << *FC.vars[c.src] << "\n";
+            break;
+          case Constraint::MissedObj:
+            errs() << "[ERROR] Allocation site was missed by the pre-scan: " << *FC.vars[c.src] << "\n";
+            exit(-1);
+          default: // Field statements, see FieldAccessesOf().
+            break;
+        }
+      }
     }
 
     string ExtractObjClass(Value *v) {
@@ -490,193 +1216,1440 @@ namespace {
       
     }
 
-    void ProcessCall(Module &M, Value *x, Value *oi) {
-      vector<Function*>tmp = RM_; // RM_ will be changed all the time. It will make the following loop go wrong.
-      for(Function *F : tmp) {
-        size_t callSite = 0;
-        // PrintRM();
-        // errs() << "\t\t\t\t\tnow process: " << *F  << "\n";
-        
-        for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {        
-          for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-            callSite++;
-            Function *func = NULL; // Store the callSite callee function.
-            string callee;
-            // errs() << "now process inst: " << *inst << "\n";
-            if(CallInst *call = dyn_cast<CallInst>(inst)) {
-              // errs() << "It is a call: " << *inst << "\n";
-              if(call->isIndirectCall()) { // If it is indirect call (i.e., a tmp variable from load instrustion.)
-                // errs() << "\t[+] Indirect call" << "\n";
-                Value *virtual_call_name = call->getOperand(call->getNumOperands() - 1); // The last operand is the virtual call name.
-                Instruction *virtual_call_inst = dyn_cast<Instruction>(virtual_call_name); // It must be a load inst.
-
-                // errs() << "\t\t" << *virtual_call_inst << "\n";
-                // errs() << "\t\t" << *oi << "\n";
-                callee = Dispatch(x, oi, virtual_call_inst); // Dispatch the virtual call.
-                if(callee != "") {
-                  // errs() << "\t\t[*]Find function: " << callee << "\n"; 
-                  func = M.getFunction(callee);
-                } else {
-                  continue;
-                }
-              } else { // If it is direct call, then we can get its function name immediately.
-                // errs() << "\t[+] Direct call" << *call <<"\n";
-                func = call->getCalledFunction();
-                // errs() << "\t\tcalled func: " << *func << "\n";
-                
-                // If we can get instruction, then it is not the library function.
-                if(func->begin() != func->end()) {
-                  // errs() << "\t\tDirect call process\n";
-                  Instruction *firstInst = dyn_cast<Instruction>(func->begin()->begin());
-                  string firstInstClass = ExtractObjClass(firstInst); // Find dircet call's class.
-                  string oiClass = ExtractObjClass(oi); // Find obj oi's class.
-                  if(oiClass == firstInstClass) { // If direct call belongs to oi object.
-                    callee = func->getName().data();
-                    // errs() << "\t\t[*] Direct call name is: " << callee << "\n";
-                  } else {
-                    continue;
-                  }
-                } else { // Otherwise it is a library function, we will not process it.
-                  func = NULL;
-                }
-
-                // errs() << "\t\tfinish this call process\n";
-                
-              }
-
-              if(func) { // Dispatch success.
-                // errs() << "dispatch func: " << func->getName() << "\n";
-                // Process this obj.
-                BitVector tmp = BitVector(objCount_, false);
-                tmp[Obj_[oi]] = true;
-                WL_.push(pair<Value*, BitVector>(dyn_cast<Instruction>(func->begin()->begin()), tmp)); // add <mthis, {oi}> to WL.
-                string caller = F->getName().data();
-                bool isExist = false;
-                if(CG_.find(caller) != CG_.end()) { // If this caller's CG exists, then check if caller -> <callSite, callee> exists.
-                  for(pair<size_t, string> target : CG_[caller]) {
-                    if(target.first == callSite && target.second == callee) {
-                      isExist = true;
-                      break;
-                    }
-                  }
-                  if(!isExist) { // If caller -> <callSite, callee> does not exist, than add it. 
-                    CG_[caller].push_back(pair<size_t, string>(callSite, callee));
-                  }
-                } else { // If this caller's CG does not exist, than add it.
-                  vector<pair<size_t, string>>tmp;
-                  tmp.push_back(pair<size_t, string>(callSite, callee));
-                  CG_.insert(pair<string, vector<pair<size_t, string>>>(caller, tmp));
-                }
-
-                if(!isExist) { // If not caller -> <callSite, callee> exist.
-                  // errs() << "Add reachable to func: " << func->getName() << "\n"; 
-                  AddReachable(func);
-
-                  // Process params and arguments.
-                  size_t idx = 0;
-                  for (Argument &Arg : func->args()) { // Get function's params.
-                    if(idx > 0) { // Skip param: this, because we already process before.
-                      // errs() <<  Arg << " : ";
-                      Value *param = &Arg;
-                      /// TODO: Should we process if param is a pointer obj? i.e., if param is like int *p ?
-                      if(ConvertValueToString(param).find("*, ") != string::npos) { // If param is a pointer.
-                        Value *ai = ParsingArgument(call, idx);
-                        if (!dyn_cast<Constant>(ai)) {
-                          errs() << func->getName() << " argument: " << *ai << "\n";
-                          AddEdge(ai, param);
-                        } else {
-                          errs() << func->getName() << " constant argument: " << *ai << "\n";
-                          continue;
-                        }
-                      }
-                      
-                      
-                    }
-                    idx++;
-                  }
-                   
+    // Offset of a virtual call in the vtable, i.e. the call of
+    // load (getelementptr (load vptr), offset), or -1 for other calls.
+    int VirtualCallOffset(CallInst *call) {
+      LoadInst *fn = dyn_cast<LoadInst>(call->getCalledOperand());
+      if(!fn) {
+        return -1;
+      }
+      GetElementPtrInst *gep = dyn_cast<GetElementPtrInst>(fn->getPointerOperand());
+      if(!gep || gep->getNumOperands() != 2) {
+        return -1;
+      }
+      ConstantInt *offset = dyn_cast<ConstantInt>(gep->getOperand(1));
+      return offset ? offset->getSExtValue() : -1;
+    }
 
-                  // Process the ret value propagate. 
-                  //if(func->getReturnType()->getTypeID() != Type::VoidTyID ) { // Not void.
-                  if(func->getReturnType()->getTypeID() == Type::PointerTyID ) { // If it is a pointer.
-                    // Process the ret value in the call site.
-                    Value *callValue = dyn_cast<Value>(inst);
-                    // errs() << "Now process ret value: " << *callValue << "\n";
-                    Value *r = NULL;
-                    for(User *U : callValue->users()) {
-                      if(StoreInst *store = dyn_cast<StoreInst>(U)) {
-                        r = store->getOperand(1);
-                        break;
-                      } else if(dyn_cast<BitCastInst>(U)) {
-                        User *tmp = U->user_back();
-                        if(StoreInst *store = dyn_cast<StoreInst>(U)) {
-                          r = store->getOperand(1);
-                          break;
-                        } else {
-                          errs() << "[ERROR] Unhandled exception when get the ret value. The inst is: " << *inst << "\n";
-                          exit(-4);
-                        }
-                      }
-                    }
-                    if(r == NULL) {
-                      errs() << "[ERROR] Unhandled exception when get the ret value. The inst is: " << *inst << "\n";
-                      exit(-4);
-                    }
+    // @return the vtable name if `store` installs a vtable (as constructors
+    // do), otherwise "".
+    string StoredVTable(StoreInst *store) {
+      ConstantExpr *gep = dyn_cast<ConstantExpr>(store->getValueOperand()->stripPointerCasts());
+      if(!gep || gep->getOpcode() != Instruction::GetElementPtr) {
+        return "";
+      }
+      GlobalVariable *gv = dyn_cast<GlobalVariable>(gep->getOperand(0));
+      if(!gv || vTable_.find(gv->getName().str()) == vTable_.end()) {
+        return "";
+      }
+      return gv->getName().str();
+    }
 
-                    // errs() << "return value at call site: " << *r << "\n";
-
-
-                    // Find all ret in func (callee).
-                    for (Function::iterator bb = func->begin(); bb != func->end(); ++bb) {        
-                      for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-                        if(ReturnInst *mret = dyn_cast<ReturnInst>(inst)) {
-                          Value *mretValue = mret->getReturnValue();
-                          if(LoadInst *load = dyn_cast<LoadInst>(mretValue)) {
-                            mretValue = load->getOperand(0);
-                            // errs() << "return value in callee: " << *mretValue << "\n";
-                            AddEdge(mretValue, r);
-                          } else if(Constant *c = dyn_cast<Constant>(mretValue)) {
-                            errs() << "[INFO] Return a constant, no pointer analysis needed here: " << *mret <<"\n";
-                          } else {
-                            errs() << "[ERROR] Unhandled exception when get the ret value in callee. The inst is: " << *mret 
-                                   << "  ->  " << *mretValue << "\n";
-                            exit(-4);
-                          }
-                        }
-                      }
-                    }
-                  }
+    bool IsRTACallee(CallInst *call, Function *callee) {
+      DenseMap<CallInst*, vector<Function*>>::iterator it = rtaCallees_.find(call);
+      return it != rtaCallees_.end() &&
+             std::find(it->second.begin(), it->second.end(), callee) != it->second.end();
+    }
 
-                } else { 
+    // Rapid type analysis from `root`. A virtual call at offset k may call
+    // slot k of every vtable installed by a reachable method, and a direct
+    // call calls its callee. Each instruction of a reachable method is
+    // visited once, plus once per (virtual call site, live vtable) pair.
+    void BuildRTA(Module &M, vector<Function*> &roots) {
+      vector<Function*> worklist;
+      vector<pair<CallInst*, int>> virtualSites;
+      set<string> liveVTables;
+
+      auto reach = [&](Function *F) {
+        if(F && !F->isDeclaration() && rtaRMSet_.insert(F).second) {
+          Materialize(F);
+          rtaRM_.push_back(F);
+          worklist.push_back(F);
+        }
+      };
+      auto addCallee = [&](CallInst *call, Function *F) {
+        if(!F || F->isDeclaration() || IsRTACallee(call, F)) {
+          return;
+        }
+        rtaCallees_[call].push_back(F);
+        reach(F);
+      };
+      auto addSlot = [&](CallInst *call, int offset, const string &vTable) {
+        vector<string> &slots = vTable_[vTable];
+        if(offset < (int)slots.size()) {
+          addCallee(call, M.getFunction(slots[offset]));
+        }
+      };
 
+      for(Function *root : roots) {
+        reach(root);
+      }
+      while(!worklist.empty()) {
+        Function *F = worklist.back();
+        worklist.pop_back();
+        for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
+          for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
+            if(StoreInst *store = dyn_cast<StoreInst>(inst)) {
+              string vTable = StoredVTable(store);
+              if(vTable != "" && liveVTables.insert(vTable).second) { // A new class is instantiated.
+                for(pair<CallInst*, int> &site : virtualSites) {
+                  addSlot(site.first, site.second, vTable);
                 }
               }
-              // errs() << "next call\n";
+            } else if(CallInst *call = dyn_cast<CallInst>(inst)) {
+              if(!call->isIndirectCall()) {
+                addCallee(call, call->getCalledFunction());
+                continue;
+              }
+              int offset = VirtualCallOffset(call);
+              if(offset < 0) {
+                continue;
+              }
+              virtualSites.push_back(pair<CallInst*, int>(call, offset));
+              for(const string &vTable : liveVTables) {
+                addSlot(call, offset, vTable);
+              }
             }
           }
         }
-        // errs() << "Next func\n";//*/
       }
-      // errs() << "finish process call\n";
+      hyt::Results().Text() << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+                            << " RTA: " << rtaRM_.size() << " reachable method(s), "
+                            << rtaCallees_.size() << " call site(s), "
+                            << liveVTables.size() << " instantiated class(es)\n";
+      if(lazy_) {
+        unsigned defined = 0;
+        for (Function &F : M) {
+          defined += !F.isDeclaration();
+        }
+        hyt::Results().Text() << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+                              << " Loaded " << rtaRM_.size() << " of " << defined << " function bodies.\n";
+      }
     }
 
+    // Load the body of F if M was opened lazily and F is not loaded yet.
+    void Materialize(Function *F) {
+      if(!F->isMaterializable()) {
+        return;
+      }
+      TimeTraceScope trace("Materialize", F->getName());
+      if(Error E = F->materialize()) {
+        errs() << "[ERROR] Cannot load the body of " << F->getName() << ": " << toString(std::move(E)) << "\n";
+        exit(-1);
+      }
+      ++NumMaterialized;
+    }
 
-    // void testResize() {
-    //   BitVector a = BitVector(6, false);
-    //   BitVector b = BitVector(12, false);
-
-    //   a[0] = true;a[2] = true;a[4] = true;a[5] = true;
+    // Use the RTA result as the call graph.
+    void UseRTACallGraph() {
+      for(Function *F : rtaRM_) {
+        RM_.push_back(F);
+        RMSet_.insert(F);
+        for(CallInst *call : CallSitesOf(F)) {
+          for(Function *callee : rtaCallees_[call]) {
+            AddCallEdge(call, callee);
+          }
+        }
+      }
+    }
 
-    //   PrintBitVector(a);
-    //   a.resize(b.size());
-    //   PrintBitVector(a);
-    // }
+    // Call sites of F. With -hyt-pta-cg=rta-filter only the sites the RTA
+    // pre-pass found a callee with a body for are kept.
+    vector<CallInst*>& CallSitesOf(Function *F) {
+      map<Function*, vector<CallInst*>>::iterator it = callSites_.find(F);
+      if(it != callSites_.end()) {
+        return it->second;
+      }
+      vector<CallInst*> &sites = callSites_[F];
+      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
+        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
+          if(CallInst *call = dyn_cast<CallInst>(inst)) {
+            if(CGMode == PreciseCG || rtaCallees_.count(call)) {
+              sites.push_back(call);
+            }
+          }
+        }
+      }
+      return sites;
+    }
 
+    // Add caller -> <callSite, callee>.
+    /// @return false if the edge already exists.
+    bool AddCallEdge(CallInst *callSite, Function *callee) {
+      if(!cgEdges_.insert(pair<CallInst*, Function*>(callSite, callee)).second) {
+        return false;
+      }
+      CG_[callSite->getFunction()].push_back(pair<CallInst*, Function*>(callSite, callee));
+      return true;
+    }
 
-    // Entry of Pointer Analysis.
-    bool runOnModule(Module &M) override {
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
-             << " Start\n";
+    // Freeze CG_ into CSR form. The callees of cgNodes_[i] are
+    // cgCallees_[cgOffsets_[i]] ... cgCallees_[cgOffsets_[i + 1] - 1],
+    // and cgNodes_ follows the order of RM_.
+    void FreezeCallGraph() {
+      cgNodes_ = RM_;
+      cgOffsets_.assign(1, 0);
+      cgCallees_.clear();
+      for(Function *F : cgNodes_) {
+        DenseMap<Function*, vector<pair<CallInst*, Function*>>>::iterator it = CG_.find(F);
+        if(it != CG_.end()) {
+          cgCallees_.insert(cgCallees_.end(), it->second.begin(), it->second.end());
+        }
+        cgOffsets_.push_back(cgCallees_.size());
+      }
+      CG_.clear();
+      cgEdges_.clear();
+    }
+
+    // Expose the frozen call graph as an llvm::CallGraph: the direct calls
+    // of the module plus the virtual calls the analysis resolved.
+    void BuildLLVMCallGraph(Module &M) {
+      llvmCG_.reset(new CallGraph(M));
+      for(size_t caller = 0; caller < cgNodes_.size(); caller++) {
+        CallGraphNode *callerNode = llvmCG_->getOrInsertFunction(cgNodes_[caller]);
+        for(unsigned idx = cgOffsets_[caller]; idx < cgOffsets_[caller + 1]; idx++) {
+          CallInst *call = cgCallees_[idx].first;
+          if(!call->isIndirectCall()) { // Already added by CallGraph itself.
+            continue;
+          }
+          CallGraphNode *calleeNode = llvmCG_->getOrInsertFunction(cgCallees_[idx].second);
+          // The first resolved callee replaces the edge to the external node.
+          bool isReplaced = false;
+          for(CallGraphNode::iterator edge = callerNode->begin(); edge != callerNode->end(); ++edge) {
+            if(edge->first && *edge->first == call && edge->second == llvmCG_->getCallsExternalNode()) {
+              callerNode->replaceCallEdge(*call, *call, calleeNode);
+              isReplaced = true;
+              break;
+            }
+          }
+          if(!isReplaced) {
+            callerNode->addCalledFunction(call, calleeNode);
+          }
+        }
+      }
+    }
+
+    const CallGraph &getCallGraph() const {
+      return *llvmCG_;
+    }
+
+    // Group the solved nodes into equivalence classes by points-to set, so
+    // the output and the alias results store each distinct set once.
+    void CompressPointsTo() {
+      ptClassOf_.clear();
+      ptClassSet_ = InternPointsToSets(ptClassOf_);
+    }
+
+    // Intern the points-to sets: equal sets get the same id.
+    /// @param ids, receives the set id of every node.
+    /// @return the distinct sets, indexed by id.
+    vector<BitVector> InternPointsToSets(vector<unsigned> &ids) {
+      vector<BitVector> sets;
+      map<vector<unsigned>, unsigned> setId; // Set bits => set id.
+      ids.resize(PT_.size());
+      for(unsigned n = 0; n < PT_.size(); n++) {
+        vector<unsigned> bits;
+        for(unsigned bit : PT_[n].set_bits()) {
+          bits.push_back(bit);
+        }
+        map<vector<unsigned>, unsigned>::iterator found = setId.find(bits);
+        if(found == setId.end()) {
+          found = setId.insert(pair<vector<unsigned>, unsigned>(bits, sets.size())).first;
+          sets.push_back(PT_[n]);
+        }
+        ids[n] = found->second;
+      }
+      return sets;
+    }
+
+    // @return the variables whose points-to set is complete, i.e. every
+    // value stored into them is modeled by the solver: a fresh allocation, see
+    // IsFreshObject(), or a copy of another complete variable. The object of
+    // any other call, e.g. a factory or getter, may be returned twice, so it
+    // makes the variable incomplete. Arguments are never complete, a
+    // method can be reached through a base class or a free function, so the
+    // solved set of `this` may miss objects. Variables whose address is taken
+    // are not complete either.
+    DenseSet<AllocaInst*> CompleteVariables() {
+      DenseMap<AllocaInst*, vector<AllocaInst*>> copyFrom; // x => every y in x = y.
+      DenseSet<AllocaInst*> incomplete;
+      for(Function *F : RM_) {
+        for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
+          for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
+            AllocaInst *x = dyn_cast<AllocaInst>(inst);
+            if(!x || !x->getAllocatedType()->isPointerTy()) {
+              continue;
+            }
+            vector<AllocaInst*> &sources = copyFrom[x];
+            for(User *U : x->users()) {
+              if(isa<LoadInst>(U)) {
+                continue;
+              }
+              StoreInst *store = dyn_cast<StoreInst>(U);
+              if(!store || store->getPointerOperand() != x) { // Address of x escapes.
+                incomplete.insert(x);
+                break;
+              }
+              Value *rightV = store->getValueOperand();
+              LoadInst *load = dyn_cast<LoadInst>(rightV);
+              Value *obj = AllocationSite(store);
+              if(load && dyn_cast<AllocaInst>(load->getPointerOperand())) {
+                sources.push_back(dyn_cast<AllocaInst>(load->getPointerOperand()));
+              } else if(!obj || !IsFreshObject(obj)) {
+                incomplete.insert(x);
+                break;
+              }
+            }
+          }
+        }
+      }
+      // A copy of an incomplete variable is incomplete.
+      bool isChanged = true;
+      while(isChanged) {
+        isChanged = false;
+        for(DenseMap<AllocaInst*, vector<AllocaInst*>>::iterator it = copyFrom.begin(); it != copyFrom.end(); ++it) {
+          if(incomplete.count(it->first)) {
+            continue;
+          }
+          for(AllocaInst *y : it->second) {
+            if(incomplete.count(y) || !copyFrom.count(y)) {
+              incomplete.insert(it->first);
+              isChanged = true;
+              break;
+            }
+          }
+        }
+      }
+      DenseSet<AllocaInst*> complete;
+      for(DenseMap<AllocaInst*, vector<AllocaInst*>>::iterator it = copyFrom.begin(); it != copyFrom.end(); ++it) {
+        if(!incomplete.count(it->first)) {
+          complete.insert(it->first);
+        }
+      }
+      return complete;
+    }
+
+    // Package the solved points-to sets for alias queries. A pointer loaded
+    // from a complete, non-empty variable gets the variable's set, and an
+    // object allocated by `new`, `new[]` or malloc gets its singleton set.
+    // Other calls, e.g. factories, may return an object that already exists.
+    // Pointers without a set, e.g. arguments, may alias anything.
+    AliasSets BuildAliasSets() {
+      vector<unsigned> &ids = ptClassOf_;
+      vector<BitVector> sets = ptClassSet_;
+      DenseMap<const Value*, unsigned> setOf;
+
+      DenseSet<AllocaInst*> complete = CompleteVariables();
+      for(Function *F : RM_) {
+        for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
+          for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
+            LoadInst *load = dyn_cast<LoadInst>(inst);
+            if(!load || !load->getType()->isPointerTy()) {
+              continue;
+            }
+            AllocaInst *x = dyn_cast<AllocaInst>(load->getPointerOperand());
+            const BitVector *pts = x ? PointsToSetOf(x) : NULL;
+            if(pts && complete.count(x) && pts->any()) {
+              setOf[load] = ids[valueNode_[x]];
+            }
+          }
+        }
+      }
+      for(size_t idx = 0; idx < objCount_; idx++) {
+        if(!IsFreshObject(objValue_[idx])) {
+          continue;
+        }
+        BitVector single(objCount_, false);
+        single.set(idx);
+        setOf[getUnderlyingObject(objValue_[idx])] = sets.size();
+        sets.push_back(single);
+      }
+      return AliasSets{std::move(sets), std::move(setOf)};
+    }
+
+    std::unique_ptr<HytPTAAAResult> BuildAAResult() {
+      AliasSets alias = BuildAliasSets();
+      return std::unique_ptr<HytPTAAAResult>(new HytPTAAAResult(std::move(alias.sets), alias.setOf));
+    }
+
+    // @return the set of the object V points into, as -hytPTA-aa sees it, or
+    // NULL if V has no set, see BuildAliasSets().
+    const BitVector* AliasSetOf(const Value *V) {
+      if(!aliasSets_) {
+        aliasSets_ = BuildAliasSets();
+      }
+      DenseMap<const Value*, unsigned>::iterator it = aliasSets_->setOf.find(getUnderlyingObject(V));
+      return it == aliasSets_->setOf.end() ? NULL : &aliasSets_->sets[it->second];
+    }
+
+    // @return the `new` call that allocates obj.
+    CallInst* NewCallOf(Value *obj) {
+      return dyn_cast<CallInst>(dyn_cast<Instruction>(obj)->getOperand(0));
+    }
+
+    // @return true if obj is fresh memory: allocated by `new`, `new[]` or
+    // malloc, or moved to the stack by PromoteHeapToStack().
+    static bool IsFreshObject(Value *obj) {
+      Value *site = dyn_cast<Instruction>(obj)->getOperand(0);
+      if(isa<AllocaInst>(site)) {
+        return true;
+      }
+      CallInst *call = dyn_cast<CallInst>(site);
+      Function *callee = call ? call->getCalledFunction() : NULL;
+      if(!callee) {
+        return false;
+      }
+      StringRef name = callee->getName();
+      return name == "_Znwm" || name == "_Znam" || name == "malloc";
+    }
+
+    // @return the method a PFG node lives in, or NULL if it is not local.
+    Function* OwnerOf(Value *n) {
+      if(Instruction *inst = dyn_cast<Instruction>(n)) {
+        return inst->getFunction();
+      }
+      if(Argument *arg = dyn_cast<Argument>(n)) {
+        return arg->getParent();
+      }
+      return NULL;
+    }
+
+    // @return true if PT_(n) contains object idx.
+    bool PointsTo(Value *n, size_t idx) {
+      const BitVector *pts = PointsToSetOf(n);
+      return pts && pts->test(idx);
+    }
+
+    // @return the methods reachable from F in the LLVM call graph, F included.
+    DenseSet<Function*> ReachableFrom(Function *F) {
+      DenseSet<Function*> reach;
+      vector<Function*> stack(1, F);
+      reach.insert(F);
+      while(!stack.empty()) {
+        CallGraphNode *node = (*llvmCG_)[stack.back()];
+        stack.pop_back();
+        for(CallGraphNode::iterator edge = node->begin(); edge != node->end(); ++edge) {
+          Function *callee = edge->second->getFunction();
+          if(callee && reach.insert(callee).second) {
+            stack.push_back(callee);
+          }
+        }
+      }
+      return reach;
+    }
+
+    // @return true if F calls itself, directly or not.
+    bool IsRecursive(Function *F) {
+      CallGraphNode *node = (*llvmCG_)[F];
+      for(CallGraphNode::iterator edge = node->begin(); edge != node->end(); ++edge) {
+        Function *callee = edge->second->getFunction();
+        if(callee && ReachableFrom(callee).count(F)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // @return true if BB can run more than once per call of its method.
+    bool IsInCycle(BasicBlock *BB) {
+      SmallPtrSet<BasicBlock*, 16> visited;
+      vector<BasicBlock*> stack(succ_begin(BB), succ_end(BB));
+      while(!stack.empty()) {
+        BasicBlock *cur = stack.back();
+        stack.pop_back();
+        if(cur == BB) {
+          return true;
+        }
+        if(visited.insert(cur).second) {
+          stack.insert(stack.end(), succ_begin(cur), succ_end(cur));
+        }
+      }
+      return false;
+    }
+
+    // Everything the escape analysis of one object needs to carry around.
+    struct EscapeQuery {
+      size_t idx; // The object.
+      DenseSet<Function*> allowed; // Methods whose frames end before the allocating one.
+      DenseMap<CallInst*, vector<Function*>> targets; // Resolved indirect calls.
+      SmallPtrSet<Value*, 32> visited;
+      vector<CallInst*> deletes; // `delete` calls that free the object.
+    };
+
+    // @return true if the callee param `arg` of `call` is bound to the
+    // object in a way the escape analysis follows.
+    bool IsModeledParam(EscapeQuery &Q, CallInst *call, Function *callee, unsigned arg, bool isExact) {
+      if(callee->isDeclaration()) {
+        if(arg == 0 && (callee->getName() == "_ZdlPv" || callee->getName() == "_ZdlPvm")) {
+          if(!isExact) { // Could free the stack object of another site.
+            return false;
+          }
+          if(std::find(Q.deletes.begin(), Q.deletes.end(), call) == Q.deletes.end()) {
+            Q.deletes.push_back(call);
+          }
+          return true;
+        }
+        return false;
+      }
+      if(arg >= callee->arg_size() || !Q.allowed.count(callee)) {
+        return false;
+      }
+      Value *param = callee->getArg(arg);
+      if(PointsTo(param, Q.idx) || (arg == 0 && PointsTo(&*callee->begin()->begin(), Q.idx))) {
+        return true; // Solved by the PFG, the param is checked as a node.
+      }
+      // Bindings the solver skipped, e.g. the `this` of a base class
+      // constructor, are followed through the callee instead.
+      return IsModeledUse(Q, param, false);
+    }
+
+    // @return true if every use of v, a pointer to the object, keeps the
+    // object inside the frames in Q.allowed and is modeled, i.e. no use
+    // stores it into memory the solver does not track or hands it to code
+    // it cannot see.
+    /// @param isExact, v points to this object only.
+    bool IsModeledUse(EscapeQuery &Q, Value *v, bool isExact) {
+      if(!Q.visited.insert(v).second) {
+        return true;
+      }
+      for(User *U : v->users()) {
+        if(isa<LoadInst>(U) || isa<ICmpInst>(U)) { // Reads the object.
+          continue;
+        }
+        if(StoreInst *store = dyn_cast<StoreInst>(U)) {
+          if(store->getValueOperand() != v) { // Writes into the object.
+            continue;
+          }
+          AllocaInst *x = dyn_cast<AllocaInst>(store->getPointerOperand());
+          if(!x || !Q.allowed.count(x->getFunction())) {
+            return false;
+          }
+          if(PointsTo(x, Q.idx)) { // x = y solved by the PFG, x is checked as a node.
+            continue;
+          }
+          // A slot the solver skipped: follow its loads if its address is not taken.
+          size_t stores = 0;
+          for(User *XU : x->users()) {
+            StoreInst *xStore = dyn_cast<StoreInst>(XU);
+            if(xStore && xStore->getPointerOperand() == x && xStore->getValueOperand() != x) {
+              stores++;
+            } else if(!isa<LoadInst>(XU)) {
+              return false;
+            }
+          }
+          for(User *XU : x->users()) {
+            if(isa<LoadInst>(XU) && !IsModeledUse(Q, XU, isExact && stores == 1)) {
+              return false;
+            }
+          }
+          continue;
+        }
+        if(isa<BitCastInst>(U) || isa<GetElementPtrInst>(U) || isa<PHINode>(U) || isa<SelectInst>(U)) {
+          if(!IsModeledUse(Q, U, isExact && isa<BitCastInst>(U))) {
+            return false;
+          }
+          continue;
+        }
+        if(IntrinsicInst *intrinsic = dyn_cast<IntrinsicInst>(U)) {
+          switch(intrinsic->getIntrinsicID()) {
+            case Intrinsic::memset: case Intrinsic::memcpy: case Intrinsic::memmove:
+            case Intrinsic::lifetime_start: case Intrinsic::lifetime_end:
+              continue;
+            default:
+              return false;
+          }
+        }
+        if(CallInst *call = dyn_cast<CallInst>(U)) {
+          if(call->getCalledOperand() == v) {
+            return false;
+          }
+          vector<Function*> callees;
+          if(Function *callee = call->getCalledFunction()) {
+            callees.push_back(callee);
+          } else {
+            DenseMap<CallInst*, vector<Function*>>::iterator it = Q.targets.find(call);
+            if(it == Q.targets.end()) { // Unresolved, could be anything.
+              return false;
+            }
+            callees = it->second;
+          }
+          for(unsigned arg = 0; arg < call->arg_size(); arg++) {
+            if(call->getArgOperand(arg) != v) {
+              continue;
+            }
+            for(Function *callee : callees) {
+              if(!IsModeledParam(Q, call, callee, arg, isExact)) {
+                return false;
+              }
+            }
+          }
+          continue;
+        }
+        if(ReturnInst *ret = dyn_cast<ReturnInst>(U)) { // ProcessCall() only models `ret (load x)`.
+          LoadInst *load = dyn_cast<LoadInst>(ret->getReturnValue());
+          if(load && PointsTo(load->getPointerOperand(), Q.idx)) {
+            continue;
+          }
+          return false;
+        }
+        return false; // ptrtoint, invoke, ...
+      }
+      return true;
+    }
+
+    // Escape analysis over the solved PT_/PFG_. An object does not escape
+    // its allocating method A if every PFG node that may hold it lives in A
+    // or in a method A calls, A is not recursive, and every use of those
+    // nodes is modeled (see IsModeledUse()).
+    /// @param deletes, receives the `delete` calls of the objects that do not escape.
+    /// @return for each object, true if it escapes.
+    vector<bool> AnalyzeEscape(vector<vector<CallInst*>> &deletes) {
+      vector<bool> isEscaped(objCount_, true);
+      deletes.assign(objCount_, vector<CallInst*>());
+      if(budgetExceeded_) { // The methods added from RTA have no nodes.
+        return isEscaped;
+      }
+
+      vector<vector<unsigned>> nodes(objCount_); // Object => PFG nodes holding it.
+      for(unsigned n = 0; n < PT_.size(); n++) {
+        for(unsigned idx : PT_[n].set_bits()) {
+          nodes[idx].push_back(n);
+        }
+      }
+      DenseMap<CallInst*, vector<Function*>> targets;
+      for(pair<CallInst*, Function*> &edge : cgCallees_) {
+        if(edge.first->isIndirectCall()) {
+          targets[edge.first].push_back(edge.second);
+        }
+      }
+
+      for(size_t idx = 0; idx < objCount_; idx++) {
+        CallInst *call = NewCallOf(objValue_[idx]);
+        Function *A = call->getFunction();
+        if(!RMSet_.count(A) || IsRecursive(A)) {
+          continue;
+        }
+        EscapeQuery Q;
+        Q.idx = idx;
+        Q.allowed = ReachableFrom(A);
+        Q.targets = targets;
+        bool isModeled = IsModeledUse(Q, call, true);
+        for(size_t n = 0; isModeled && n < nodes[idx].size(); n++) {
+          Value *node = nodeValue_[nodes[idx][n]];
+          Function *owner = node ? OwnerOf(node) : NULL;
+          bool isExact = PT_[nodes[idx][n]].count() == 1;
+          if(!owner || !Q.allowed.count(owner)) { // A field, or a value that is not local.
+            isModeled = false;
+          } else if(isa<Argument>(node)) {
+            isModeled = IsModeledUse(Q, node, isExact);
+          } else if(isa<AllocaInst>(node)) {
+            for(User *U : node->users()) {
+              StoreInst *store = dyn_cast<StoreInst>(U);
+              if(isa<LoadInst>(U)) {
+                isModeled = isModeled && IsModeledUse(Q, U, isExact);
+              } else if(!store || store->getPointerOperand() != node || store->getValueOperand() == node) {
+                isModeled = false; // The address of the variable is taken.
+              }
+            }
+          } else { // A value the solver does not model.
+            isModeled = false;
+          }
+        }
+        if(isModeled) {
+          isEscaped[idx] = false;
+          deletes[idx] = Q.deletes;
+        }
+      }
+      return isEscaped;
+    }
+
+    void PrintEscape(vector<bool> &isEscaped) {
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsSummary)) {
+        for(size_t idx = 0; idx < objCount_; idx++) {
+          results.Label("escape", idx, isEscaped[idx] ? "escapes" : "stays");
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsSummary);
+      OS << "  [" << "\033[34m" << "+" << "\033[0m" << "]"
+         << " Escape: \n";
+      for(size_t idx = 0; idx < objCount_; idx++) {
+        OS << "\t" << *objValue_[idx] << " => " << idx
+           << (isEscaped[idx] ? " escapes " : " stays in ")
+           << NewCallOf(objValue_[idx])->getFunction()->getName() << "\n";
+      }
+    }
+
+    // Turn the `new` of objects that do not escape into stack allocations
+    // in the entry block of the allocating method, and drop their `delete`.
+    // A `new` in a cycle is kept, its objects may be alive at the same time.
+    // With -hyt-pta-h2s-dynamic a dynamic size gets an alloca at the `new`,
+    // so the frame of the method serves as the arena.
+    /// @return true if the module changed.
+    bool PromoteHeapToStack(vector<bool> &isEscaped, vector<vector<CallInst*>> &deletes) {
+      size_t fixed = 0, dynamic = 0, kept = 0;
+      for(size_t idx = 0; idx < objCount_; idx++) {
+        if(isEscaped[idx]) {
+          continue;
+        }
+        CallInst *call = NewCallOf(objValue_[idx]);
+        Function *callee = call->getCalledFunction();
+        if(!callee || callee->getName() != "_Znwm") { // Not a `new`, it may take no size.
+          kept++;
+          continue;
+        }
+        ConstantInt *size = dyn_cast<ConstantInt>(call->getArgOperand(0));
+        if(IsInCycle(call->getParent()) ||
+           (size && size->getZExtValue() > HeapToStackMaxSize) || (!size && !HeapToStackDynamic)) {
+          kept++;
+          continue;
+        }
+        Function *A = call->getFunction();
+        Instruction *insertPt = size ? &*A->getEntryBlock().getFirstInsertionPt() : call;
+        AllocaInst *slot = new AllocaInst(Type::getInt8Ty(call->getContext()),
+                                          A->getParent()->getDataLayout().getAllocaAddrSpace(),
+                                          call->getArgOperand(0), Align(16), "h2s", insertPt);
+        call->replaceAllUsesWith(slot);
+        call->eraseFromParent();
+        for(CallInst *del : deletes[idx]) {
+          del->eraseFromParent();
+        }
+        size ? fixed++ : dynamic++;
+      }
+      hyt::Results().Text() << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+                            << " Moved " << fixed + dynamic << " allocation(s) to the stack: "
+                            << fixed << " fixed size, " << dynamic << " dynamic, "
+                            << kept << " kept on the heap.\n";
+      return fixed + dynamic > 0;
+    }
+
+    // Rewrite the virtual calls resolved in the frozen call graph. A site
+    // with up to -hyt-pta-devirt-max-targets targets gets one guarded direct
+    // call per target (if (fn == @target) target(...) else fn(...)). The
+    // indirect call stays as the fallback, even for a single target: the
+    // targets are only complete for a full solve from main, not under the
+    // RTA call graph or -hyt-pta-roots=external|exported|list, where the
+    // objects that reach the roots are unknown, nor for a Partial() result,
+    // whose edges come partly from RTA.
+    /// @return true if the module changed.
+    bool Devirtualize() {
+      MapVector<CallInst*, vector<Function*>> targets;
+      for(pair<CallInst*, Function*> &edge : cgCallees_) {
+        if(edge.first->isIndirectCall()) {
+          targets[edge.first].push_back(edge.second);
+        }
+      }
+
+      size_t guarded = 0, skipped = 0;
+      for(pair<CallInst*, vector<Function*>> &site : targets) {
+        CallInst *call = site.first;
+        vector<Function*> &callees = site.second;
+        bool isLegal = callees.size() <= DevirtMaxTargets;
+        for(Function *callee : callees) {
+          isLegal = isLegal && isLegalToPromote(*call, callee);
+        }
+        if(!isLegal) {
+          skipped++;
+          continue;
+        }
+        for(Function *callee : callees) {
+          promoteCallWithIfThenElse(*call, callee);
+        }
+        guarded++;
+      }
+      hyt::Results().Text() << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+                            << " Devirtualized " << guarded << " call site(s) with guarded direct calls, "
+                            << skipped << " skipped.\n";
+      return guarded > 0;
+    }
+
+    void ProcessCall(Module &M, Value *x, Value *oi) {
+      TimeTraceScope trace("ProcessCall");
+      vector<Function*>tmp = RM_; // RM_ will be changed all the time. It will make the following loop go wrong.
+      for(Function *F : tmp) {
+        // PrintRM();
+        // errs() << "\t\t\t\t\tnow process: " << *F  << "\n";
+        
+        for(CallInst *call : CallSitesOf(F)) {
+          Instruction *inst = call;
+          Function *func = NULL; // Store the callSite callee function.
+          string callee;
+          // errs() << "It is a call: " << *inst << "\n";
+          if(call->isIndirectCall()) { // If it is indirect call (i.e., a tmp variable from load instrustion.)
+            // errs() << "\t[+] Indirect call" << "\n";
+            Value *virtual_call_name = call->getOperand(call->getNumOperands() - 1); // The last operand is the virtual call name.
+            Instruction *virtual_call_inst = dyn_cast<Instruction>(virtual_call_name); // It must be a load inst.
+
+            // errs() << "\t\t" << *virtual_call_inst << "\n";
+            // errs() << "\t\t" << *oi << "\n";
+            callee = Dispatch(x, oi, virtual_call_inst); // Dispatch the virtual call.
+            if(callee != "") {
+              // errs() << "\t\t[*]Find function: " << callee << "\n"; 
+              func = M.getFunction(callee);
+              // Not a target the pre-pass allows, or, for lazy bitcode, loaded.
+              if((CGMode == RTAFilteredCG || lazy_) && !IsRTACallee(call, func)) {
+                continue;
+              }
+            } else {
+              continue;
+            }
+          } else { // If it is direct call, then we can get its function name immediately.
+            // errs() << "\t[+] Direct call" << *call <<"\n";
+            func = call->getCalledFunction();
+            // errs() << "\t\tcalled func: " << *func << "\n";
+                
+            // If we can get instruction, then it is not the library function.
+            if(func->begin() != func->end()) {
+              // errs() << "\t\tDirect call process\n";
+              Instruction *firstInst = dyn_cast<Instruction>(func->begin()->begin());
+              string firstInstClass = ExtractObjClass(firstInst); // Find dircet call's class.
+              string oiClass = ExtractObjClass(oi); // Find obj oi's class.
+              if(oiClass == firstInstClass) { // If direct call belongs to oi object.
+                callee = func->getName().data();
+                // errs() << "\t\t[*] Direct call name is: " << callee << "\n";
+              } else {
+                continue;
+              }
+            } else { // Otherwise it is a library function, we will not process it.
+              func = NULL;
+            }
+
+            // errs() << "\t\tfinish this call process\n";
+                
+          }
+
+          if(func) { // Dispatch success.
+            // errs() << "dispatch func: " << func->getName() << "\n";
+            // Process this obj.
+            BitVector tmp = BitVector(objCount_, false);
+            tmp[Obj_[oi]] = true;
+            WL_.push(pair<unsigned, BitVector>(NodeOf(&*func->begin()->begin()), tmp)); // add <mthis, {oi}> to WL.
+            ++NumWorklistPushes;
+            ++NumBitVectorAllocs;
+            bool isExist = !AddCallEdge(call, func); // Add caller -> <callSite, callee> if it does not exist.
+
+            if(!isExist) { // If not caller -> <callSite, callee> exist.
+              // errs() << "Add reachable to func: " << func->getName() << "\n"; 
+              AddReachable(func);
+
+              // Process params and arguments.
+              size_t idx = 0;
+              for (Argument &Arg : func->args()) { // Get function's params.
+                if(idx > 0) { // Skip param: this, because we already process before.
+                  // errs() <<  Arg << " : ";
+                  Value *param = &Arg;
+                  /// TODO: Should we process if param is a pointer obj? i.e., if param is like int *p ?
+                  if(ConvertValueToString(param).find("*, ") != string::npos) { // If param is a pointer.
+                    Value *ai = ParsingArgument(call, idx);
+                    if (!dyn_cast<Constant>(ai)) {
+                      if(hyt::Results().WantsText(hyt::ResultsFull)) {
+                        hyt::Results().Text(hyt::ResultsFull) << func->getName() << " argument: " << *ai << "\n";
+                      }
+                      AddEdge(NodeOf(ai), NodeOf(param));
+                    } else {
+                      if(hyt::Results().WantsText(hyt::ResultsFull)) {
+                        hyt::Results().Text(hyt::ResultsFull) << func->getName() << " constant argument: " << *ai << "\n";
+                      }
+                      continue;
+                    }
+                  }
+                      
+                      
+                }
+                idx++;
+              }
+                   
+
+              // Process the ret value propagate. 
+              //if(func->getReturnType()->getTypeID() != Type::VoidTyID ) { // Not void.
+              if(func->getReturnType()->getTypeID() == Type::PointerTyID ) { // If it is a pointer.
+                // Process the ret value in the call site.
+                Value *callValue = dyn_cast<Value>(inst);
+                // errs() << "Now process ret value: " << *callValue << "\n";
+                Value *r = NULL;
+                for(User *U : callValue->users()) {
+                  if(StoreInst *store = dyn_cast<StoreInst>(U)) {
+                    r = store->getOperand(1);
+                    break;
+                  } else if(dyn_cast<BitCastInst>(U)) {
+                    User *tmp = U->user_back();
+                    if(StoreInst *store = dyn_cast<StoreInst>(U)) {
+                      r = store->getOperand(1);
+                      break;
+                    } else {
+                      errs() << "[ERROR] Unhandled exception when get the ret value. The inst is: " << *inst << "\n";
+                      exit(-4);
+                    }
+                  }
+                }
+                if(r == NULL) {
+                  errs() << "[ERROR] Unhandled exception when get the ret value. The inst is: " << *inst << "\n";
+                  exit(-4);
+                }
+
+                // errs() << "return value at call site: " << *r << "\n";
+
+
+                // Find all ret in func (callee).
+                for (Function::iterator bb = func->begin(); bb != func->end(); ++bb) {        
+                  for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
+                    if(ReturnInst *mret = dyn_cast<ReturnInst>(inst)) {
+                      Value *mretValue = mret->getReturnValue();
+                      if(LoadInst *load = dyn_cast<LoadInst>(mretValue)) {
+                        mretValue = load->getOperand(0);
+                        // errs() << "return value in callee: " << *mretValue << "\n";
+                        AddEdge(NodeOf(mretValue), NodeOf(r));
+                      } else if(Constant *c = dyn_cast<Constant>(mretValue)) {
+                        errs() << "[INFO] Return a constant, no pointer analysis needed here: " << *mret <<"\n";
+                      } else {
+                        errs() << "[ERROR] Unhandled exception when get the ret value in callee. The inst is: " << *mret 
+                               << "  ->  " << *mretValue << "\n";
+                        exit(-4);
+                      }
+                    }
+                  }
+                }
+              }
+
+            } else { 
+
+            }
+          }
+          // errs() << "next call\n";
+        }
+        // errs() << "Next func\n";//*/
+      }
+      // errs() << "finish process call\n";
+    }
+
+
+    // void testResize() {
+    //   BitVector a = BitVector(6, false);
+    //   BitVector b = BitVector(12, false);
+
+    //   a[0] = true;a[2] = true;a[4] = true;a[5] = true;
+
+    //   PrintBitVector(a);
+    //   a.resize(b.size());
+    //   PrintBitVector(a);
+    // }
+
+
+    // Number globals, functions, arguments and instructions in module order.
+    // The numbering only depends on the IR, so it is identical across runs.
+    void NumberValues(Module &M) {
+      idValue_.clear();
+      valueId_.clear();
+      auto number = [this](Value *v) {
+        valueId_.insert(pair<Value*, uint32_t>(v, idValue_.size()));
+        idValue_.push_back(v);
+      };
+      for (GlobalVariable &gv : M.globals()) {
+        number(&gv);
+      }
+      for (Function &F : M) {
+        number(&F);
+        for (Argument &Arg : F.args()) {
+          number(&Arg);
+        }
+        for (Function::iterator bb = F.begin(); bb != F.end(); ++bb) {
+          for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
+            number(&*inst);
+          }
+        }
+      }
+    }
+
+    // Written word by word, without a copy of bv.
+    void WriteBitVector(support::endian::Writer &W, const BitVector &bv) {
+      W.write<uint32_t>(bv.size());
+      unsigned words = (bv.size() + 63) / 64, next = 0;
+      uint64_t word = 0;
+      for (unsigned idx : bv.set_bits()) {
+        for (; next < idx / 64; next++) {
+          W.write<uint64_t>(word);
+          word = 0;
+        }
+        word |= (uint64_t)1 << (idx % 64);
+      }
+      for (; next < words; next++) {
+        W.write<uint64_t>(word);
+        word = 0;
+      }
+    }
+
+    // Snapshot layout (little endian):
+    //   "HYTPTA03", #values, objCount_, Obj_, RM_, CG_, fields_, nodes, PT_, PFG_, WL_
+    // Values are stored as their index in `idValue_`, classes by name.
+    // Each snapshot is a full one, written straight from the solver state:
+    // its cost is one pass over it, O(nodes * objects / 64) words for PT_
+    // and WL_, which the default interval of 600 seconds amortizes.
+    void WriteCheckpoint() {
+      string tmpFile = checkpointPath_ + ".tmp";
+      std::error_code EC;
+      raw_fd_ostream OS(tmpFile, EC, sys::fs::OF_None);
+      if (EC) {
+        errs() << "[ERROR] Cannot open checkpoint file " << tmpFile << ": " << EC.message() << "\n";
+        return;
+      }
+      support::endian::Writer W(OS, support::little);
+      OS << "HYTPTA03";
+      W.write<uint32_t>(idValue_.size());
+      W.write<uint64_t>(objCount_);
+
+      W.write<uint32_t>(Obj_.size());
+      for (map<Value*, size_t>::iterator obj = Obj_.begin(); obj != Obj_.end(); obj++) {
+        W.write<uint32_t>(valueId_[obj->first]);
+        W.write<uint64_t>(obj->second);
+      }
+
+      W.write<uint32_t>(RM_.size());
+      for (Function *F : RM_) {
+        W.write<uint32_t>(valueId_[F]);
+      }
+
+      W.write<uint32_t>(CG_.size());
+      for (DenseMap<Function*, vector<pair<CallInst*, Function*>>>::iterator caller = CG_.begin(); caller != CG_.end(); caller++) {
+        W.write<uint32_t>(caller->second.size());
+        for (pair<CallInst*, Function*> &callee : caller->second) {
+          W.write<uint32_t>(valueId_[callee.first]);
+          W.write<uint32_t>(valueId_[callee.second]);
+        }
+      }
+
+      W.write<uint32_t>(fields_.size());
+      for (pair<StructType*, unsigned> &field : fields_) {
+        W.write<uint32_t>(field.first->getName().size());
+        OS << field.first->getName();
+        W.write<uint32_t>(field.second);
+      }
+
+      // Nodes in id order: 0, value id for a Value, 1, oi, f for oi.f.
+      W.write<uint32_t>(nodeValue_.size());
+      for (unsigned n = 0; n < nodeValue_.size(); n++) {
+        W.write<uint8_t>(nodeValue_[n] ? 0 : 1);
+        if (nodeValue_[n]) {
+          W.write<uint32_t>(valueId_[nodeValue_[n]]);
+        } else {
+          W.write<uint32_t>(nodeField_[n].first);
+          W.write<uint32_t>(nodeField_[n].second);
+        }
+      }
+      for (unsigned n = 0; n < nodeValue_.size(); n++) {
+        WriteBitVector(W, PT_[n]);
+        W.write<uint32_t>(PFG_[n].size());
+        for (unsigned target : PFG_[n]) {
+          W.write<uint32_t>(target);
+        }
+      }
+
+      W.write<uint32_t>(WL_.size());
+      for (const pair<unsigned, BitVector> &working : hyt::ContainerOf(WL_)) {
+        W.write<uint32_t>(working.first);
+        WriteBitVector(W, working.second);
+      }
+
+      OS.close();
+      if (OS.has_error()) {
+        errs() << "[ERROR] Writing checkpoint file " << tmpFile << " failed.\n";
+        OS.clear_error();
+        return;
+      }
+      // Rename is atomic, so a preempted write never clobbers the last good snapshot.
+      if ((EC = sys::fs::rename(tmpFile, checkpointPath_))) {
+        errs() << "[ERROR] Cannot rename checkpoint file to " << checkpointPath_ << ": " << EC.message() << "\n";
+      }
+    }
+
+    // Take a snapshot. It is written in place of the solver, not by a
+    // forked child: hyt-analyze runs the pass on several threads, and a child
+    // of a threaded process may only make async-signal-safe calls.
+    void Checkpoint() {
+      WriteCheckpoint();
+      lastCheckpoint_ = std::chrono::steady_clock::now();
+    }
+
+    // -hyt-pta-checkpoint=<file> of M is <file>.<hash of the module
+    // identifier>, so modules analyzed at once keep their own snapshots.
+    static string CheckpointPath(Module &M) {
+      return CheckpointFile + "." + utohexstr(xxHash64(M.getModuleIdentifier()));
+    }
+
+    // Cursor over a snapshot buffer. Every read is bounds checked, a
+    // truncated or foreign snapshot stops the analysis.
+    struct CheckpointReader {
+      const char *cur;
+      const char *end;
+      StringRef path;
+
+      void Need(size_t n) {
+        if ((size_t)(end - cur) < n) {
+          errs() << "[ERROR] Checkpoint file " << path << " is truncated.\n";
+          exit(-5);
+        }
+      }
+      template <typename T> T Read() {
+        Need(sizeof(T));
+        return support::endian::readNext<T, support::little, support::unaligned>(cur);
+      }
+      BitVector ReadBitVector() {
+        uint32_t size = Read<uint32_t>();
+        BitVector bv(size, false);
+        for (uint32_t base = 0; base < size; base += 64) {
+          uint64_t word = Read<uint64_t>();
+          for (unsigned bit = 0; word; bit++, word >>= 1) {
+            if (word & 1) {
+              bv.set(base + bit);
+            }
+          }
+        }
+        return bv;
+      }
+    };
+
+    Value* CheckpointValue(uint32_t id) {
+      if (id >= idValue_.size()) {
+        errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " refers to unknown value " << id << ".\n";
+        exit(-5);
+      }
+      return idValue_[id];
+    }
+
+    unsigned CheckpointNode(uint32_t n) {
+      if (n >= nodeValue_.size()) {
+        errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " refers to unknown node " << n << ".\n";
+        exit(-5);
+      }
+      return n;
+    }
+
+    // Restore the solver state saved by WriteCheckpoint().
+    void LoadCheckpoint(Module &M) {
+      ErrorOr<std::unique_ptr<MemoryBuffer>> buffer = MemoryBuffer::getFile(checkpointPath_);
+      if (!buffer) {
+        errs() << "[ERROR] Cannot read checkpoint file " << checkpointPath_ << ": "
+               << buffer.getError().message() << "\n";
+        exit(-5);
+      }
+      CheckpointReader R = {(*buffer)->getBufferStart(), (*buffer)->getBufferEnd(), checkpointPath_};
+      R.Need(8);
+      if (string(R.cur, 8) != "HYTPTA03") {
+        errs() << "[ERROR] " << checkpointPath_ << " is not a pointer analysis checkpoint.\n";
+        exit(-5);
+      }
+      R.cur += 8;
+      if (R.Read<uint32_t>() != idValue_.size()) {
+        errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " was taken on a different module.\n";
+        exit(-5);
+      }
+      // Objects are numbered by NumberAllocationSites(), which only depends
+      // on the IR, so the snapshot must agree with the current numbering.
+      bool sameObjects = R.Read<uint64_t>() == objCount_;
+      for (uint32_t n = R.Read<uint32_t>(); n > 0; n--) {
+        Value *obj = CheckpointValue(R.Read<uint32_t>());
+        size_t idx = R.Read<uint64_t>();
+        sameObjects = sameObjects && Obj_.count(obj) && Obj_[obj] == idx;
+      }
+      if (!sameObjects) {
+        errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " has a different object numbering.\n";
+        exit(-5);
+      }
+      for (uint32_t n = R.Read<uint32_t>(); n > 0; n--) {
+        Function *F = dyn_cast<Function>(CheckpointValue(R.Read<uint32_t>()));
+        if (!F) {
+          errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " has a non-function reachable method.\n";
+          exit(-5);
+        }
+        RM_.push_back(F);
+        RMSet_.insert(F);
+      }
+      for (uint32_t n = R.Read<uint32_t>(); n > 0; n--) {
+        for (uint32_t m = R.Read<uint32_t>(); m > 0; m--) {
+          CallInst *callSite = dyn_cast<CallInst>(CheckpointValue(R.Read<uint32_t>()));
+          Function *callee = dyn_cast<Function>(CheckpointValue(R.Read<uint32_t>()));
+          if (!callSite || !callee) {
+            errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " has a malformed call edge.\n";
+            exit(-5);
+          }
+          AddCallEdge(callSite, callee);
+        }
+      }
+      for (uint32_t n = R.Read<uint32_t>(); n > 0; n--) {
+        uint32_t len = R.Read<uint32_t>();
+        R.Need(len);
+        StructType *ST = StructType::getTypeByName(M.getContext(), StringRef(R.cur, len));
+        R.cur += len;
+        uint32_t idx = R.Read<uint32_t>();
+        if (!ST || idx >= ST->getNumElements()) {
+          errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " has an unknown field.\n";
+          exit(-5);
+        }
+        FieldId(ST, idx);
+      }
+      uint32_t nodes = R.Read<uint32_t>();
+      for (uint32_t n = 0; n < nodes; n++) {
+        unsigned node;
+        if (R.Read<uint8_t>() == 0) {
+          node = NodeOf(CheckpointValue(R.Read<uint32_t>()));
+        } else {
+          uint32_t oi = R.Read<uint32_t>();
+          uint32_t f = R.Read<uint32_t>();
+          if (oi >= objCount_ || f >= fields_.size()) {
+            errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " has a malformed field node.\n";
+            exit(-5);
+          }
+          node = FieldNode(oi, f);
+        }
+        if (node != n) {
+          errs() << "[ERROR] Checkpoint file " << checkpointPath_ << " has a duplicated node.\n";
+          exit(-5);
+        }
+      }
+      for (uint32_t n = 0; n < nodes; n++) {
+        PT_[n] = R.ReadBitVector();
+        for (uint32_t m = R.Read<uint32_t>(); m > 0; m--) {
+          PFG_[n].push_back(CheckpointNode(R.Read<uint32_t>()));
+        }
+      }
+      for (uint32_t n = R.Read<uint32_t>(); n > 0; n--) {
+        unsigned node = CheckpointNode(R.Read<uint32_t>());
+        WL_.push(pair<unsigned, BitVector>(node, R.ReadBitVector()));
+      }
+
+      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+             << " Resumed from " << checkpointPath_ << " with " << RM_.size()
+             << " reachable method(s) and " << WL_.size() << " worklist entries.\n";
+    }
+
+    void PrintProgress(size_t iteration, std::chrono::steady_clock::time_point now) {
+      double elapsed = std::chrono::duration<double>(now - solveStart_).count();
+      double interval = std::chrono::duration<double>(now - lastProgress_).count();
+      double rate = interval > 0 ? (propagatedBits_ - lastPropagatedBits_) / interval : 0;
+      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]"
+             << " Progress " << format("%.1f", elapsed) << "s: iteration " << iteration
+             << ", worklist " << WL_.size() << ", nodes " << PT_.size()
+             << ", edges " << edgeCount_ << ", objects " << objCount_
+             << ", reachable methods " << RM_.size()
+             << ", propagation " << format("%.0f", rate) << " bits/s"
+             << ", filtered " << filteredBits_ << " bits\n";
+      if(hyt::MemoryLedger::Enabled()) { // Shows the heap even if the run is killed later on.
+        errs() << "      Heap:";
+        for(pair<const char*, size_t> &usage : HeapUsage()) {
+          errs() << " " << usage.first << " " << format("%.1f", usage.second / 1048576.0) << "MB";
+        }
+        errs() << "\n";
+      }
+      lastProgress_ = now;
+      lastPropagatedBits_ = propagatedBits_;
+    }
+
+    // Estimated heap bytes of each structure.
+    hyt::HeapUsageList HeapUsage() {
+      size_t constraintBytes = constraints_.capacity() * sizeof(FunctionConstraints);
+      for(FunctionConstraints &FC : constraints_) {
+        constraintBytes += hyt::HeapBytes(FC.vars) + hyt::HeapBytes(FC.fields) + hyt::HeapBytes(FC.constraints);
+      }
+      size_t nodeBytes = hyt::HeapBytes(nodeValue_) + hyt::HeapBytes(nodeField_) + hyt::HeapBytes(valueNode_) +
+                         hyt::HeapBytes(fieldNode_) + hyt::HeapBytes(nodeClass_);
+      return {
+        {"PT_", hyt::HeapBytes(PT_)},
+        {"PFG_", hyt::HeapBytes(PFG_)},
+        {"WL_", hyt::HeapBytes(WL_)},
+        {"constraints_", constraintBytes},
+        {"nodes", nodeBytes},
+        {"fieldAccesses_", hyt::HeapBytes(fieldAccesses_)},
+        {"classMask_", hyt::HeapBytes(classMask_)},
+        {"CG_", hyt::HeapBytes(CG_) + hyt::HeapBytes(cgEdges_) + hyt::HeapBytes(callSites_)},
+        {"ptClassSet_", hyt::HeapBytes(ptClassSet_) + hyt::HeapBytes(ptClassOf_)},
+        {"Obj_", hyt::HeapBytes(Obj_) + hyt::HeapBytes(objValue_)},
+      };
+    }
+
+    // Raise the high-water marks of the structures in `phase`.
+    void SampleMemory(StringRef phase) {
+      for(pair<const char*, size_t> &usage : HeapUsage()) {
+        memory_.Sample(phase, usage.first, usage.second);
+      }
+    }
+
+    // @return true if the solver ran out of any of its budgets.
+    bool IsOutOfBudget(size_t iteration, std::chrono::steady_clock::time_point now) {
+      if(IterationBudget && iteration > IterationBudget) {
+        errs() << "[Warning] Iteration budget of " << IterationBudget << " exceeded.\n";
+        return true;
+      }
+      if(TimeBudget && now - solveStart_ >= std::chrono::seconds(TimeBudget)) {
+        errs() << "[Warning] Time budget of " << TimeBudget << "s exceeded.\n";
+        return true;
+      }
+      if(MemoryBudget && sys::Process::GetMallocUsage() >= (size_t)MemoryBudget * 1024 * 1024) {
+        errs() << "[Warning] Memory budget of " << MemoryBudget << "MB exceeded.\n";
+        return true;
+      }
+      return false;
+    }
+
+    // Give up on the precise (inclusion based) solution and fall back to a
+    // coarse but sound one. The methods and call edges not discovered yet
+    // are taken from the RTA call graph, which covers every call the solver
+    // could still have resolved. The pending worklist is dropped, and every
+    // PFG node gets every object its class may hold (every object without
+    // -hyt-pta-type-filter or for an unfiltered node), so no flow along a
+    // missing field or call edge is lost. The nodes of the methods reached
+    // here have no set at all, so their pointers are unknown to every query.
+    void CollapseRemaining(Module &M, vector<Function*> &roots) {
+      while(!WL_.empty()) {
+        WL_.pop();
+      }
+      if(CGMode == PreciseCG && !lazy_) { // Not built before solving.
+        BuildRTA(M, roots);
+      }
+      size_t solved = RM_.size();
+      for(Function *F : rtaRM_) {
+        if(RMSet_.insert(F).second) {
+          RM_.push_back(F);
+        }
+        for(CallInst *call : CallSitesOf(F)) {
+          DenseMap<CallInst*, vector<Function*>>::iterator it = rtaCallees_.find(call);
+          if(it == rtaCallees_.end()) {
+            continue;
+          }
+          for(Function *callee : it->second) {
+            AddCallEdge(call, callee);
+          }
+        }
+      }
+
+      BitVector all(objCount_, true);
+      for(unsigned n = 0; n < PT_.size(); n++) {
+        PT_[n] = TypeFilter && nodeClass_[n] != NoClass ? classMask_[nodeClass_[n]] : all;
+      }
+      budgetExceeded_ = true;
+      errs() << "[Warning] Pointer analysis stopped early after " << solved
+             << " method(s), " << PT_.size() << " node(s) collapsed to their class and "
+             << RM_.size() - solved << " method(s) added from RTA. Results are coarse.\n";
+    }
+
+    // @return true if the solver stopped on a budget. The points-to sets
+    // and the call graph are then over-approximated by CollapseRemaining():
+    // still sound for alias queries and guarded devirtualization, but the
+    // methods added from RTA have no PFG nodes, so escape analysis, which
+    // needs every flow of an object, is skipped.
+    bool Partial() const {
+      return budgetExceeded_;
+    }
+
+    // @return the entry points selected by -hyt-pta-roots. All of them are
+    // solved together, on one PFG.
+    vector<Function*> FindRoots(Module &M) {
+      vector<Function*> roots;
+      if(Roots == MainRoot) {
+        if(Function *F = M.getFunction("main")) {
+          roots.push_back(F);
+        }
+        return roots;
+      }
+      if(Roots == ListRoots) {
+        ErrorOr<std::unique_ptr<MemoryBuffer>> buffer = MemoryBuffer::getFile(RootsFile);
+        if(!buffer) {
+          errs() << "[ERROR] Cannot read entry point list " << RootsFile << ": "
+                 << buffer.getError().message() << "\n";
+          exit(-2);
+        }
+        SmallVector<StringRef, 64> lines;
+        (*buffer)->getBuffer().split(lines, '\n', -1, false);
+        for(StringRef line : lines) {
+          line = line.trim();
+          if(line.empty() || line.startswith("#")) {
+            continue;
+          }
+          Function *F = M.getFunction(line);
+          if(!F || F->isDeclaration()) {
+            errs() << "[Warning] Entry point " << line << " is not defined in the module.\n";
+            continue;
+          }
+          roots.push_back(F);
+        }
+        return roots;
+      }
+      for(Function &F : M) {
+        if(F.isDeclaration() || F.hasLocalLinkage()) {
+          continue;
+        }
+        if(Roots == ExportedRoots && (!F.hasExternalLinkage() || !F.hasDefaultVisibility())) {
+          continue;
+        }
+        roots.push_back(&F);
+      }
+      return roots;
+    }
+
+    // Append the solver statistics of this run to -hyt-pta-report as one
+    // JSON line, so runs on different inputs or builds can be compared.
+    void WriteReport(Module &M) {
+      size_t setBits = 0;
+      for(BitVector &pts : PT_) {
+        setBits += pts.count();
+      }
+      hyt::HeapUsageList heap;
+      if(hyt::MemoryLedger::Enabled()) {
+        for(pair<const char*, size_t> &usage : HeapUsage()) {
+          heap.push_back({usage.first, memory_.Peak(usage.first)});
+        }
+      }
+      hyt::AppendReport(ReportFile, [&](json::OStream &J) {
+        J.attribute("module", M.getModuleIdentifier());
+        J.attribute("solve_seconds", solveSeconds_);
+        J.attribute("worklist_pops", (int64_t)worklistPops_);
+        J.attribute("propagated_bits", (int64_t)propagatedBits_);
+        J.attribute("filtered_bits", (int64_t)filteredBits_);
+        J.attribute("objects", (int64_t)objCount_);
+        J.attribute("nodes", (int64_t)PT_.size());
+        J.attribute("field_nodes", (int64_t)fieldNode_.size());
+        J.attribute("edges", (int64_t)edgeCount_);
+        J.attribute("sets", (int64_t)ptClassSet_.size());
+        J.attribute("set_bits", (int64_t)setBits);
+        J.attribute("reachable_methods", (int64_t)RM_.size());
+        J.attribute("call_edges", (int64_t)cgCallees_.size());
+        if(lazy_) {
+          J.attribute("loaded_functions", (int64_t)rtaRM_.size());
+        }
+        J.attribute("budget_exceeded", budgetExceeded_);
+      }, heap);
+    }
+
+    void getAnalysisUsage(AnalysisUsage &AU) const override {
+      AU.addRequired<HytPTAAAWrapperPass>();
+      if(!DevirtualizeCalls && !HeapToStack) {
+        AU.setPreservesAll();
+      }
+    }
+
+    bool doInitialization(Module &M) override {
+      hyt::TimeTraceBegin("hytDFA_PointerAnalysis");
+      return false;
+    }
+
+    bool doFinalization(Module &M) override {
+      if(hyt::MemoryLedger::Enabled()) {
+        memory_.PrintTop("hytDFA_PointerAnalysis", errs());
+      }
+      hyt::Results().Flush();
+      hyt::TimeTraceEnd();
+      return false;
+    }
+
+    // Solve the points-to sets of M, or only its RTA call graph, and write
+    // -hyt-pta-report. The results are written by PrintResults().
+    void Solve(Module &M) {
+      hyt::ResultSink &results = hyt::Results();
+      results.Begin("pta", M.getModuleIdentifier());
+      results.Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                     << " Start\n";
+      DL_ = &M.getDataLayout();
+      Optional<hyt::Region> region;
+      region.emplace("init", "Parse vtables and extract constraints", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
       // Analysis the vTable structure.
       for (auto gv_iter = M.global_begin();gv_iter != M.global_end(); gv_iter++) {
         /* GLOBAL DATA INFO*/
@@ -709,13 +2682,17 @@ namespace {
         }
         
       }
-#ifdef SHOW_INFO
-      PrintVTable(vTable_);
-#endif
+      if(results.Wants(hyt::ResultsFull)) {
+        PrintVTable(vTable_);
+      }
 
-      Function *F = M.getFunction("main");
-      if (!F) {
-        errs() << "[ERROR] Main Function Not Found! Analysis is stopped\n";
+      vector<Function*> roots = FindRoots(M);
+      if (roots.empty()) {
+        if (Roots == MainRoot) {
+          errs() << "[ERROR] Main Function Not Found! Analysis is stopped\n";
+        } else {
+          errs() << "[ERROR] No entry point found! Analysis is stopped\n";
+        }
         exit(-2);
       }
 
@@ -728,121 +2705,301 @@ namespace {
 
       // DoInit(M, F);
 
-#ifndef SHOW_INFO
-      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {        
-        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-          string instStr = ConvertValueToString(dyn_cast<Value>(inst));
-          if(instStr.find("getelementptr inbounds") != string::npos) {
-            errs() << *inst << " : " << inst->getNumOperands() << "\n";
-          }
+      for (Function &F : M) {
+        lazy_ |= F.isMaterializable();
+      }
+      if(CGMode != PreciseCG || lazy_) { // Also decides which bodies lazy bitcode loads.
+        BuildRTA(M, roots);
+      }
+      if(CGMode == RTACG) { // Fast mode, the RTA call graph is the result.
+        UseRTACallGraph();
+        FreezeCallGraph();
+        BuildLLVMCallGraph(M);
+        return;
+      }
+
+      NumberAllocationSites(M);
+      ExtractAllConstraints(M);
+      if(!CheckpointFile.empty()) {
+        checkpointPath_ = CheckpointPath(M);
+        NumberValues(M);
+        lastCheckpoint_ = std::chrono::steady_clock::now();
+      } else if(ResumeFromCheckpoint) {
+        errs() << "[ERROR] -hyt-pta-resume needs -hyt-pta-checkpoint=<file>.\n";
+        exit(-5);
+      }
+
+      if(ResumeFromCheckpoint) {
+        LoadCheckpoint(M);
+      } else {
+        for(Function *root : roots) {
+          AddReachable(root);
         }
       }
-#endif 
-      AddReachable(F);
+      if(hyt::MemoryLedger::Enabled()) {
+        SampleMemory("init");
+      }
+      region.emplace("solve", "Solve", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      size_t iteration = 0;
+      solveStart_ = lastProgress_ = lastMemorySample_ = std::chrono::steady_clock::now();
       while(!WL_.empty()) {
-        pair<Value*, BitVector> working = WL_.front(); // working = <n, pts>
+        // Checking the clock is not free, so only look at it every 1024 iterations.
+        if((++iteration & 1023) == 0 || (IterationBudget && iteration > IterationBudget)) {
+          std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+          if(IsOutOfBudget(iteration, now)) {
+            CollapseRemaining(M, roots);
+            break;
+          }
+          if(!CheckpointFile.empty() && now - lastCheckpoint_ >= std::chrono::seconds(CheckpointInterval)) {
+            Checkpoint();
+          }
+          if(ProgressInterval && now - lastProgress_ >= std::chrono::seconds(ProgressInterval)) {
+            PrintProgress(iteration, now);
+          }
+          // WL_ peaks while solving, so sample the heap once a second.
+          if(hyt::MemoryLedger::Enabled() && now - lastMemorySample_ >= std::chrono::seconds(1)) {
+            SampleMemory("solve");
+            lastMemorySample_ = now;
+          }
+        }
+        pair<unsigned, BitVector> working = WL_.front(); // working = <n, pts>
         WL_.pop();
+        worklistPops_++;
+        ++NumWorklistPops;
         BitVector delta = BitVector(objCount_, false);
+        ++NumBitVectorAllocs;
 
         // PrintObj(); 
         // errs() << "  [" << "\033[34m" << "+" << "\033[0m" << "]" 
-        //        << " Now process: " << *(working.first) << " ";
-        // errs() << "With pts: ";
+        //        << " Now process: ";
+        // PrintNode(working.first);
+        // errs() << " With pts: ";
         // PrintBitVector(working.second);
 
-        if(PT_.find(working.first) == PT_.end()) {
-          BitVector tmp = BitVector(objCount_, false);
-          PT_.insert(pair<Value*, BitVector>(working.first, tmp));
-        }
-
-        if(working.second.size() < objCount_) {
-          working.second.resize(objCount_);
-        }
-
-        if(PT_[working.first].size() < objCount_) {
-          PT_[working.first].resize(objCount_);
-        }
-
         BitVectorSub(working.second, PT_[working.first], delta); // delta = pts - pt[n]
 
         Propagate(working.first, delta);
 
-        if(dyn_cast<AllocaInst>(working.first)) { // If n is a variable x.
-          for(size_t idx = 0; idx < delta.size(); idx++) { // Foreach oi in delta.
-            //First find oi.
-            if(delta[idx]) {
-              Value *oi;
-              for(map<Value*, size_t>::iterator it = Obj_.begin(); it != Obj_.end(); it++) {
-                if(it->second == idx) {
-                  oi = it->first;
-                  break;
-                }
-              }
-              
-              // errs() << "Current obj: " << *oi << "\n";
+        Value *x = nodeValue_[working.first];
+        if(AllocaInst *var = dyn_cast_or_null<AllocaInst>(x)) { // If n is a variable x.
+          for(unsigned idx : delta.set_bits()) { // Foreach oi in delta.
+            Value *oi = objValue_[idx];
 
-              // Find y = x.f or x.f = y
-              for(Function *F : RM_) {
-                size_t callSite = 0;
-                for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {        
-                  for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-                    if(StoreInst *store = dyn_cast<StoreInst>(inst)) {
-                      // errs() << "process store inst: " << *store << "\n";
-                      Value *leftV = store->getOperand(1);
-                      Value *rightV = store->getOperand(0);
-                      Value *fieldV = NULL;
+            // errs() << "Current obj: " << *oi << "\n";
 
-                      
-                      if(dyn_cast<AllocaInst>(leftV)) { // Maybe y = x.f
-                        fieldV = rightV;
-                      } else if(dyn_cast<AllocaInst>(rightV)) { // Mayby x.f = y
-                        fieldV = leftV;
-                      } else {
-                        continue;
-                      }
-
-                      Instruction *fieldInst = dyn_cast<Instruction>(fieldV);
-                      string fieldVStr = ConvertValueToString(fieldV);
-                      if(fieldVStr.find("getelementptr inbounds") != string::npos && fieldInst->getNumOperands() == 3) {
-                        string fieldObjClass = ExtractObjClass(fieldV);
-                        string oiClass = ExtractObjClass(oi);
-                        // errs() << "fieldV: " << *fieldV << "\n";
-                        // errs() << "oi: " << *oi << "\n";
-                        if(oiClass == fieldObjClass) { // if oi and x.f belong to the same class, than x.f here is oi.f
-                          AddEdge(rightV, leftV); // add oi.f -> y or x -> oi.f
-                        }
-                      }
-                    }
-                  }
-                }
+            // Foreach y = x.f: add oi.f -> y, foreach x.f = y: add y -> oi.f.
+            for(FieldAccess &access : FieldAccessesOf(var)) {
+              unsigned f = ObjectField(idx, access.field);
+              if(f == access.field && !classMask_[InternClass(fields_[f].first)].test(idx)) { // oi has no such field.
+                continue;
+              }
+              unsigned field = FieldNode(idx, f);
+              if(access.isLoad) {
+                AddEdge(field, NodeOf(access.y));
+              } else {
+                AddEdge(NodeOf(access.y), field);
               }
-
-              // ProcessCall(x, oi)
-              // errs() << "process call\n";
-              // PrintRM();
-              ProcessCall(M, working.first, oi);
-
             }
+
+            // ProcessCall(x, oi)
+            // errs() << "process call\n";
+            // PrintRM();
+            ProcessCall(M, x, oi);
           }
         }
       } // while()
+      solveSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - solveStart_).count();
+      if(hyt::MemoryLedger::Enabled()) {
+        SampleMemory("solve");
+      }
+      FreezeCallGraph();
+      BuildLLVMCallGraph(M);
+      CompressPointsTo();
+      if(hyt::MemoryLedger::Enabled()) {
+        SampleMemory("compress");
+      }
+      if(!ReportFile.empty()) {
+        WriteReport(M);
+      }
+    }
 
-      errs() << "  [" << "\033[34m" << "+" << "\033[0m" << "]"
-             << " Final Result: \n";
-      PrintObj();
-      PrintCG();
-      PrintRM();
-      PrintPT();
-      PrintPFG();
+    // Write the results, up to results.End(), see EndResults().
+    void PrintResults(Module &M) {
+      hyt::ResultSink &results = hyt::Results();
+      if(!results.InScope("pta", M.getModuleIdentifier())) { // A cached result.
+        results.Begin("pta", M.getModuleIdentifier());
+      }
+      hyt::Region region("print", "Print results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      results.Text() << "  [" << "\033[34m" << "+" << "\033[0m" << "]"
+                     << " Final Result: \n";
+      if(CGMode == RTACG) {
+        PrintRM();
+        PrintCG();
+        results.Count("reachable_methods", RM_.size());
+        results.Count("call_edges", cgCallees_.size());
+        return;
+      }
+      if(results.Wants(hyt::ResultsFull)) {
+        PrintObj();
+      }
+      if(results.WantsRecords(hyt::ResultsSummary)) { // Method ids first, the call edges refer to them.
+        PrintRM();
+        PrintCG();
+      } else {
+        PrintCG();
+        PrintRM();
+      }
+      if(results.Wants(hyt::ResultsFull)) {
+        PrintPT();
+        PrintPFG();
+      }
+      results.Count("objects", objCount_);
+      results.Count("nodes", PT_.size());
+      results.Count("edges", edgeCount_);
+      results.Count("sets", ptClassSet_.size());
+      results.Count("reachable_methods", RM_.size());
+      results.Count("call_edges", cgCallees_.size());
+      if(Partial()) {
+        results.Text() << "[Warning] Coarse result, the solver stopped on a budget.\n";
+        results.Count("partial", 1);
+      }
+    }
 
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
-             << " Finised\n";
+    void EndResults() {
+      hyt::ResultSink &results = hyt::Results();
+      results.End();
+      results.Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                     << " Finised\n";
+    }
 
-      return false;
+    // Entry of Pointer Analysis.
+    bool runOnModule(Module &M) override {
+      TimeTraceScope trace("hytDFA_PointerAnalysis", M.getModuleIdentifier());
+      Solve(M);
+      PrintResults(M);
+
+      hyt::Region region("transform", "Escape analysis, devirtualization and alias results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      if(CGMode == RTACG) {
+        bool isChanged = DevirtualizeCalls && Devirtualize();
+        EndResults();
+        return isChanged;
+      }
+      bool isChanged = false;
+      if(ShowEscape || HeapToStack) {
+        vector<vector<CallInst*>> deletes;
+        vector<bool> isEscaped = AnalyzeEscape(deletes);
+        if(ShowEscape) {
+          PrintEscape(isEscaped);
+        }
+        if(HeapToStack) {
+          isChanged = PromoteHeapToStack(isEscaped, deletes);
+        }
+      }
+      if(DevirtualizeCalls) {
+        isChanged = Devirtualize() || isChanged;
+      }
 
+      getAnalysis<HytPTAAAWrapperPass>().Result = BuildAAResult();
+
+      EndResults();
+      return isChanged;
     }
   };
 }
 
 char hytProgramAnalysis::ID = 0;
-static RegisterPass<hytProgramAnalysis> X("hytDFA_PointerAnalysis", "Hyt Program Analysis For Pointer Analysis");
\ No newline at end of file
+static RegisterPass<hytProgramAnalysis> X("hytDFA_PointerAnalysis", "Hyt Program Analysis For Pointer Analysis");
+
+char HytPTAAAWrapperPass::ID = 0;
+static RegisterPass<HytPTAAAWrapperPass> Y("hytPTA-aa-result", "Hyt Pointer Analysis Alias Results", false, true);
+
+// `-hytPTA-aa` adds the pointer analysis results to the AA chain of later
+// passes, e.g. opt -hytDFA_PointerAnalysis -hytPTA-aa -gvn.
+// LLVM only looks for external AA under ExternalAAWrapperPass's own ID, so
+// the pass is registered by hand under a name of its own.
+static void AddHytPTAAAResult(Pass &P, Function &F, AAResults &AAR) {
+  if(HytPTAAAWrapperPass *WP = P.getAnalysisIfAvailable<HytPTAAAWrapperPass>()) {
+    if(WP->Result) {
+      AAR.addAAResult(*WP->Result);
+    }
+  }
+}
+static Pass *CreateHytPTAExternalAA() {
+  return createExternalAAWrapperPass(AddHytPTAAAResult);
+}
+static char HytPTAExternalAAID = 0;
+static PassInfo HytPTAExternalAAInfo("Hyt Pointer Analysis Alias Analysis", "hytPTA-aa",
+                                     &HytPTAExternalAAID, CreateHytPTAExternalAA, false, true);
+static struct RegisterHytPTAExternalAA {
+  RegisterHytPTAExternalAA() {
+    PassRegistry::getPassRegistry()->registerPass(HytPTAExternalAAInfo);
+  }
+} Z;
+
+// New pass manager, see HytAnalysis.h. Only the analysis is ported: the
+// escape analysis, the transforms and -hytPTA-aa stay with the legacy pass.
+namespace hyt {
+  AnalysisKey PointsToAnalysis::Key;
+
+  PointsTo::PointsTo(std::unique_ptr<ModulePass> solver) : solver_(std::move(solver)) {}
+  PointsTo::PointsTo(PointsTo &&) = default;
+  PointsTo::~PointsTo() = default;
+
+  ArrayRef<Value*> PointsTo::Objects() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->objValue_;
+  }
+
+  const BitVector *PointsTo::PointsToSet(const Value *V) const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->AliasSetOf(V);
+  }
+
+  bool PointsTo::MayAlias(const Value *A, const Value *B) const {
+    const BitVector *ptsA = PointsToSet(A);
+    const BitVector *ptsB = PointsToSet(B);
+    if(!ptsA || !ptsB || ptsA->none() || ptsB->none()) { // Not modeled.
+      return true;
+    }
+    return ptsA->anyCommon(*ptsB);
+  }
+
+  bool PointsTo::Partial() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->Partial();
+  }
+
+  ArrayRef<Function*> PointsTo::ReachableMethods() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->RM_;
+  }
+
+  const CallGraph &PointsTo::CallGraph() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->getCallGraph();
+  }
+
+  void PointsTo::Print(Module &M) const {
+    hytProgramAnalysis *solver = static_cast<hytProgramAnalysis*>(solver_.get());
+    solver->PrintResults(M);
+    solver->EndResults();
+  }
+
+  bool PointsTo::invalidate(Module &M, const PreservedAnalyses &PA,
+                            ModuleAnalysisManager::Invalidator &Inv) {
+    PreservedAnalyses::PreservedAnalysisChecker PAC = PA.getChecker<PointsToAnalysis>();
+    return !PAC.preserved() && !PAC.preservedSet<AllAnalysesOn<Module>>();
+  }
+
+  PointsTo PointsToAnalysis::run(Module &M, ModuleAnalysisManager &AM) {
+    TimeTraceScope trace("hytDFA_PointerAnalysis", M.getModuleIdentifier());
+    std::unique_ptr<hytProgramAnalysis> solver(new hytProgramAnalysis());
+    solver->Solve(M);
+    return PointsTo(std::move(solver));
+  }
+
+  PreservedAnalyses PointsToPrinterPass::run(Module &M, ModuleAnalysisManager &AM) {
+    AM.getResult<PointsToAnalysis>(M).Print(M);
+    return PreservedAnalyses::all();
+  }
+
+  PreservedAnalyses PointsToCallGraphPrinterPass::run(Module &M, ModuleAnalysisManager &AM) {
+    AM.getResult<PointsToAnalysis>(M).CallGraph().print(hyt::Results().Text());
+    return PreservedAnalyses::all();
+  }
+}
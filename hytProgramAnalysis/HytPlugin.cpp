@@ -0,0 +1,66 @@
+//
+//
+// New pass manager plugin entry, see HytAnalysis.h.
+//
+// opt -load-pass-plugin LLVMHytDFA.so -passes='print<hyt-rd>' ...
+//
+
+
+#include "HytAnalysis.h"
+#include "HytSummary.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/PassPlugin.h"
+
+using namespace llvm;
+
+namespace {
+  // Adds print<name>, require<name> and invalidate<name> of AnalysisT.
+  template <typename AnalysisT, typename PrinterT, typename IRUnitT>
+  bool ParseHytPass(StringRef name, StringRef pass, PassManager<IRUnitT> &PM) {
+    if(pass == ("print<" + name + ">").str()) {
+      PM.addPass(PrinterT());
+      return true;
+    }
+    if(pass == ("require<" + name + ">").str()) {
+      PM.addPass(RequireAnalysisPass<AnalysisT, IRUnitT>());
+      return true;
+    }
+    if(pass == ("invalidate<" + name + ">").str()) {
+      PM.addPass(InvalidateAnalysisPass<AnalysisT>());
+      return true;
+    }
+    return false;
+  }
+
+  void RegisterHytPasses(PassBuilder &PB) {
+    PB.registerAnalysisRegistrationCallback([](FunctionAnalysisManager &FAM) {
+      FAM.registerPass([] { return hyt::IRSummaryAnalysis(); });
+      FAM.registerPass([] { return hyt::ReachingDefinitionAnalysis(); });
+      FAM.registerPass([] { return hyt::LiveVariablesAnalysis(); });
+      FAM.registerPass([] { return hyt::AvailableExpressionsAnalysis(); });
+    });
+    PB.registerAnalysisRegistrationCallback([](ModuleAnalysisManager &MAM) {
+      MAM.registerPass([] { return hyt::PointsToAnalysis(); });
+    });
+    PB.registerPipelineParsingCallback(
+        [](StringRef pass, FunctionPassManager &FPM, ArrayRef<PassBuilder::PipelineElement>) {
+          return ParseHytPass<hyt::ReachingDefinitionAnalysis, hyt::ReachingDefinitionPrinterPass>("hyt-rd", pass, FPM) ||
+                 ParseHytPass<hyt::LiveVariablesAnalysis, hyt::LiveVariablesPrinterPass>("hyt-lva", pass, FPM) ||
+                 ParseHytPass<hyt::AvailableExpressionsAnalysis, hyt::AvailableExpressionsPrinterPass>("hyt-aea", pass, FPM);
+        });
+    PB.registerPipelineParsingCallback(
+        [](StringRef pass, ModulePassManager &MPM, ArrayRef<PassBuilder::PipelineElement>) {
+          if(pass == "print<hyt-pta-callgraph>") {
+            MPM.addPass(hyt::PointsToCallGraphPrinterPass());
+            return true;
+          }
+          return ParseHytPass<hyt::PointsToAnalysis, hyt::PointsToPrinterPass>("hyt-pta", pass, MPM);
+        });
+  }
+}
+
+extern "C" LLVM_ATTRIBUTE_WEAK PassPluginLibraryInfo llvmGetPassPluginInfo() {
+  return {LLVM_PLUGIN_API_VERSION, "HytDFA", LLVM_VERSION_STRING, RegisterHytPasses};
+}
@@ -0,0 +1,248 @@
+//
+//
+// Result output shared by the passes, see HytResults.h.
+//
+
+
+#include "HytResults.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+
+#include <stdlib.h>
+#include <vector>
+
+using namespace llvm;
+
+static cl::opt<hyt::ResultLevel> ResultLevelOpt(
+    "hyt-results", cl::init(hyt::ResultsFull),
+    cl::desc("Results the hyt passes write"),
+    cl::values(clEnumValN(hyt::ResultsOff, "off", "Nothing but warnings and errors"),
+               clEnumValN(hyt::ResultsSummary, "summary", "Progress and compact results"),
+               clEnumValN(hyt::ResultsFull, "full", "Every fact, set and graph")));
+
+static cl::opt<hyt::ResultFormat> ResultFormatOpt(
+    "hyt-results-format", cl::init(hyt::ResultsText),
+    cl::desc("Format of -hyt-results"),
+    cl::values(clEnumValN(hyt::ResultsText, "text", "Human readable"),
+               clEnumValN(hyt::ResultsJSON, "jsonl", "One JSON record per line, sets as ranges"),
+               clEnumValN(hyt::ResultsBinary, "binary", "Little endian records, sets as 64-bit words")));
+
+static cl::opt<std::string> ResultFile(
+    "hyt-results-file", cl::value_desc("file"), cl::init("-"),
+    cl::desc("Write -hyt-results to <file> instead of stderr"));
+
+namespace hyt {
+  namespace {
+    // The ResultCapture of this thread, if any.
+    thread_local ResultSink *capture = nullptr;
+  }
+
+  ResultSink::ResultSink() : level_(ResultLevelOpt), format_(ResultFormatOpt), OS_(nullptr) {
+    if(level_ == ResultsOff) {
+      return;
+    }
+    if(ResultFile == "-") {
+      file_.reset(new raw_fd_ostream(2, false));
+      errs().tie(file_.get()); // Keep warnings and errors in order with the results.
+    } else {
+      std::error_code EC;
+      file_.reset(new raw_fd_ostream(ResultFile, EC,
+                                     format_ == ResultsBinary ? sys::fs::OF_None : sys::fs::OF_Text));
+      if(EC) {
+        errs() << "[ERROR] Cannot open results file " << ResultFile << ": " << EC.message() << "\n";
+        exit(-1);
+      }
+    }
+    OS_ = file_.get();
+    if(format_ == ResultsBinary) {
+      *OS_ << "HYTRES01";
+    }
+  }
+
+  ResultSink::ResultSink(raw_ostream &OS)
+    : level_(ResultLevelOpt), format_(ResultFormatOpt), OS_(level_ == ResultsOff ? nullptr : &OS) {}
+
+  ResultSink::~ResultSink() {
+    if(file_) {
+      errs().tie(nullptr);
+    }
+    Flush();
+  }
+
+  raw_ostream &ResultSink::Text(ResultLevel level) {
+    return WantsText(level) ? *OS_ : nulls();
+  }
+
+  void ResultSink::WriteString(StringRef s) {
+    support::endian::write<uint32_t>(*OS_, s.size(), support::little);
+    *OS_ << s;
+  }
+
+  void ResultSink::BeginJSON(json::OStream &J, StringRef key) {
+    J.attribute("pass", pass_);
+    J.attribute("scope", scope_);
+    J.attribute("key", key);
+  }
+
+  void ResultSink::Begin(StringRef pass, StringRef scope) {
+    if(open_) {
+      End();
+    }
+    open_ = true;
+    pass_ = pass.str();
+    scope_ = scope.str();
+    counts_ = json::Object();
+    if(format_ == ResultsBinary && WantsRecords(ResultsSummary)) {
+      *OS_ << 'B';
+      WriteString(pass);
+      WriteString(scope);
+    }
+  }
+
+  void ResultSink::Count(StringRef key, uint64_t value) {
+    if(!WantsRecords(ResultsSummary)) {
+      return;
+    }
+    if(format_ == ResultsJSON) {
+      counts_[key] = (int64_t)value;
+      return;
+    }
+    *OS_ << 'C';
+    WriteString(key);
+    support::endian::write<uint64_t>(*OS_, value, support::little);
+  }
+
+  void ResultSink::Label(StringRef key, uint64_t id, StringRef text) {
+    if(!WantsRecords(ResultsSummary)) {
+      return;
+    }
+    if(format_ == ResultsJSON) {
+      json::OStream J(*OS_);
+      J.object([&] {
+        BeginJSON(J, key);
+        J.attribute("id", (int64_t)id);
+        J.attribute("text", text);
+      });
+      *OS_ << "\n";
+      return;
+    }
+    *OS_ << 'L';
+    WriteString(key);
+    support::endian::write<uint64_t>(*OS_, id, support::little);
+    WriteString(text);
+  }
+
+  void ResultSink::Set(StringRef key, uint64_t id, const BitVector &bits) {
+    if(!WantsRecords(ResultsSummary)) {
+      return;
+    }
+    if(format_ == ResultsJSON) {
+      json::OStream J(*OS_);
+      J.object([&] {
+        BeginJSON(J, key);
+        J.attribute("id", (int64_t)id);
+        J.attributeArray("set", [&] {
+          int first = bits.find_first();
+          while(first != -1) { // One [first, last] per run of set bits.
+            int last = first;
+            int next = bits.find_next(last);
+            while(next == last + 1) {
+              last = next;
+              next = bits.find_next(last);
+            }
+            J.array([&] {
+              J.value(first);
+              J.value(last);
+            });
+            first = next;
+          }
+        });
+      });
+      *OS_ << "\n";
+      return;
+    }
+    std::vector<uint64_t> words((bits.size() + 63) / 64, 0);
+    for(unsigned idx : bits.set_bits()) {
+      words[idx / 64] |= (uint64_t)1 << (idx % 64);
+    }
+    *OS_ << 'S';
+    WriteString(key);
+    support::endian::write<uint64_t>(*OS_, id, support::little);
+    support::endian::write<uint32_t>(*OS_, bits.size(), support::little);
+    for(uint64_t word : words) {
+      support::endian::write<uint64_t>(*OS_, word, support::little);
+    }
+  }
+
+  void ResultSink::Edge(StringRef key, uint64_t from, uint64_t to) {
+    if(!WantsRecords(ResultsSummary)) {
+      return;
+    }
+    if(format_ == ResultsJSON) {
+      json::OStream J(*OS_);
+      J.object([&] {
+        BeginJSON(J, key);
+        J.attribute("from", (int64_t)from);
+        J.attribute("to", (int64_t)to);
+      });
+      *OS_ << "\n";
+      return;
+    }
+    *OS_ << 'G';
+    WriteString(key);
+    support::endian::write<uint64_t>(*OS_, from, support::little);
+    support::endian::write<uint64_t>(*OS_, to, support::little);
+  }
+
+  void ResultSink::End() {
+    if(!open_) {
+      return;
+    }
+    open_ = false;
+    if(!WantsRecords(ResultsSummary)) {
+      return;
+    }
+    if(format_ == ResultsJSON) {
+      json::OStream J(*OS_);
+      J.object([&] {
+        J.attribute("pass", pass_);
+        J.attribute("scope", scope_);
+        J.attribute("counts", json::Value(std::move(counts_)));
+      });
+      *OS_ << "\n";
+      counts_ = json::Object();
+      return;
+    }
+    *OS_ << 'E';
+  }
+
+  void ResultSink::Write(StringRef bytes) {
+    if(OS_) {
+      *OS_ << bytes;
+    }
+  }
+
+  void ResultSink::Flush() {
+    if(OS_) {
+      OS_->flush();
+    }
+  }
+
+  ResultSink &Results() {
+    if(capture) {
+      return *capture;
+    }
+    static ResultSink sink;
+    return sink;
+  }
+
+  ResultCapture::ResultCapture(raw_ostream &OS) : sink_(OS), saved_(capture) {
+    capture = &sink_;
+  }
+
+  ResultCapture::~ResultCapture() {
+    capture = saved_;
+  }
+}
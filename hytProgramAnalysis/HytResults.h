@@ -0,0 +1,115 @@
+//
+//
+// Result output shared by the passes
+//
+// All passes write their results through one ResultSink per process:
+//   -hyt-results=off|summary|full     what to write (default full). summary
+//                                     keeps the progress lines and the
+//                                     compact results, e.g. the call graph.
+//   -hyt-results-format=text|jsonl|binary
+//   -hyt-results-file=<file>          default "-", i.e. stderr.
+//
+// The output is buffered. Text is what the passes always printed; the
+// passes write it to Text(). jsonl and binary are written through the
+// record methods, one record per call:
+//   jsonl   {"pass", "scope", "key", "id", "set": [[first, last], ...]}
+//           and "text" for labels, "from"/"to" for edges, "counts" at End().
+//   binary  "HYTRES01", then records of a one byte kind and little endian
+//           fields, strings as u32 length and bytes:
+//             'B' pass, scope          'C' key, u64 value
+//             'L' key, u64 id, text    'S' key, u64 id, u32 bits, u64 words
+//             'G' key, u64 from, u64 to
+//             'E'
+// Passes check Wants*() first, so nothing is formatted that is not written.
+//
+// A ResultCapture sends the results of one thread to a buffer of its own
+// instead, e.g. for one input of a tool that analyzes many in parallel.
+//
+
+#ifndef HYT_RESULTS_H
+#define HYT_RESULTS_H
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+namespace hyt {
+  enum ResultLevel { ResultsOff, ResultsSummary, ResultsFull };
+  enum ResultFormat { ResultsText, ResultsJSON, ResultsBinary };
+
+  class ResultSink {
+  public:
+    ResultSink();
+    // A sink that writes to `OS`, without the binary header.
+    explicit ResultSink(llvm::raw_ostream &OS);
+    ~ResultSink();
+
+    ResultLevel Level() const { return level_; }
+    ResultFormat Format() const { return format_; }
+
+    // Whether results of `level` are written at all; as text; as records.
+    bool Wants(ResultLevel level) const { return level_ >= level; }
+    bool WantsText(ResultLevel level) const {
+      return level_ >= level && format_ == ResultsText;
+    }
+    bool WantsRecords(ResultLevel level) const {
+      return level_ >= level && format_ != ResultsText;
+    }
+
+    // The text stream if WantsText(level), nulls() otherwise.
+    llvm::raw_ostream &Text(ResultLevel level = ResultsSummary);
+
+    // Records of one pass over one function, or over the module. Begin()
+    // ends the scope before it if that was not ended.
+    void Begin(llvm::StringRef pass, llvm::StringRef scope);
+    // Whether Begin(pass, scope) was the last Begin() and is not ended yet.
+    bool InScope(llvm::StringRef pass, llvm::StringRef scope) const {
+      return open_ && pass_ == pass && scope_ == scope;
+    }
+    void Count(llvm::StringRef key, uint64_t value);
+    void Label(llvm::StringRef key, uint64_t id, llvm::StringRef text);
+    void Set(llvm::StringRef key, uint64_t id, const llvm::BitVector &bits);
+    void Edge(llvm::StringRef key, uint64_t from, uint64_t to);
+    void End();
+
+    // Append output of another sink of the same format, e.g. a capture.
+    void Write(llvm::StringRef bytes);
+    void Flush();
+
+  private:
+    void WriteString(llvm::StringRef s);
+    // Starts a jsonl record with "pass", "scope" and "key".
+    void BeginJSON(llvm::json::OStream &J, llvm::StringRef key);
+
+    ResultLevel level_;
+    ResultFormat format_;
+    std::unique_ptr<llvm::raw_fd_ostream> file_; // -hyt-results-file, if ours.
+    llvm::raw_ostream *OS_;
+    std::string pass_;
+    std::string scope_;
+    bool open_ = false;
+    llvm::json::Object counts_;
+  };
+
+  // The sink of the calling thread: its ResultCapture if there is one,
+  // otherwise the sink of this process, opened on first use.
+  ResultSink &Results();
+
+  // Sends Results() of the calling thread to `OS` while alive.
+  class ResultCapture {
+  public:
+    explicit ResultCapture(llvm::raw_ostream &OS);
+    ~ResultCapture();
+
+  private:
+    ResultSink sink_;
+    ResultSink *saved_;
+  };
+}
+
+#endif
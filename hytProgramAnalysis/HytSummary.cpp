@@ -0,0 +1,227 @@
+//
+//
+// IR summary shared by the data flow analyses, see HytSummary.h.
+//
+
+
+#include "HytSummary.h"
+#include "HytMemory.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/InstVisitor.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/TimeProfiler.h"
+
+#include <utility>
+
+using std::pair;
+using std::string;
+using std::vector;
+using namespace llvm;
+
+namespace {
+  class Summarizer : public InstVisitor<Summarizer> {
+  public:
+    explicit Summarizer(hyt::IRSummary &S) : S_(S) {}
+
+    void Run(Function &F) {
+      for(BasicBlock &BB : F) {
+        S_.blockIds[&BB] = S_.blocks.size();
+        S_.blocks.push_back(&BB);
+        S_.eventBegin.push_back(S_.events.size());
+        visit(BB);
+      }
+      S_.eventBegin.push_back(S_.events.size());
+      Finish();
+      FreezeCFG();
+    }
+
+    void visitAllocaInst(AllocaInst &I) {
+      variable_[&I] = S_.variables++;
+      S_.locations.push_back(&I);
+    }
+
+    void visitLoadInst(LoadInst &I) {
+      S_.events.push_back({hyt::IRSummary::Load, PointerOf(I.getPointerOperand()), &I});
+    }
+
+    void visitStoreInst(StoreInst &I) {
+      S_.events.push_back({hyt::IRSummary::Store, PointerOf(I.getPointerOperand()), &I});
+      S_.stores++;
+    }
+
+    void visitUnaryOperator(UnaryOperator &I) { VisitOperation(I); }
+    void visitBinaryOperator(BinaryOperator &I) { VisitOperation(I); }
+
+  private:
+    // @return the index of ptr in pointers_. Location ids are given in
+    // Finish(), when all variables are known.
+    uint32_t PointerOf(Value *ptr) {
+      pair<DenseMap<Value*, uint32_t>::iterator, bool> it = pointer_.insert({ptr, pointers_.size()});
+      if(it.second) {
+        pointers_.push_back(ptr);
+      }
+      return it.first->second;
+    }
+
+    void VisitOperation(Instruction &I) {
+      SmallVector<AllocaInst*, 4> reads;
+      string text = OperationText(&I, reads);
+      pair<StringMap<uint32_t>::iterator, bool> it = expression_.insert({text, S_.expressions.size()});
+      if(it.second) {
+        for(AllocaInst *var : reads) {
+          readers_.push_back({var, it.first->second});
+        }
+        S_.expressions.push_back(std::move(text));
+      }
+      S_.events.push_back({hyt::IRSummary::Operation, it.first->second, &I});
+    }
+
+    // The text of an operand, as Available Expressions has always named
+    // them: " x" for variable x, the text of the operation that computed
+    // it, " <constant>" for constants and nothing for other values. Loads
+    // are looked through.
+    /// @param reads, receives the variables the text names.
+    string OperandText(Value *v, SmallVectorImpl<AllocaInst*> &reads) {
+      Instruction *inst = dyn_cast<Instruction>(v);
+      if(!inst) {
+        if(v->hasName()) {
+          return " " + v->getName().str();
+        }
+        string text;
+        raw_string_ostream OS(text);
+        v->printAsOperand(OS, false);
+        return " " + OS.str();
+      }
+      if(AllocaInst *var = dyn_cast<AllocaInst>(inst)) {
+        if(!is_contained(reads, var)) {
+          reads.push_back(var);
+        }
+        return " " + var->getName().str();
+      }
+      if(LoadInst *load = dyn_cast<LoadInst>(inst)) {
+        return OperandText(load->getPointerOperand(), reads);
+      }
+      if(isa<UnaryOperator>(inst) || isa<BinaryOperator>(inst)) {
+        return OperationText(inst, reads);
+      }
+      return "";
+    }
+
+    // The operands joined by " <opcode> ".
+    string OperationText(Instruction *inst, SmallVectorImpl<AllocaInst*> &reads) {
+      string text;
+      for(unsigned i = 0; i < inst->getNumOperands(); i++) {
+        text += OperandText(inst->getOperand(i), reads);
+        if(i != inst->getNumOperands() - 1) {
+          text += " ";
+          text += inst->getOpcodeName();
+          text += " ";
+        }
+      }
+      return text;
+    }
+
+    // Turn the pointer indexes of the events into location ids, variables
+    // first, and the readers into variable ids.
+    void Finish() {
+      vector<uint32_t> location(pointers_.size());
+      for(uint32_t idx = 0; idx < pointers_.size(); idx++) {
+        DenseMap<Value*, uint32_t>::iterator var = variable_.find(pointers_[idx]);
+        if(var != variable_.end()) {
+          location[idx] = var->second;
+        } else {
+          location[idx] = S_.locations.size();
+          S_.locations.push_back(pointers_[idx]);
+        }
+      }
+      for(hyt::IRSummary::Event &event : S_.events) {
+        if(event.kind != hyt::IRSummary::Operation) {
+          event.id = location[event.id];
+        }
+      }
+      S_.readers.resize(S_.variables);
+      for(pair<AllocaInst*, uint32_t> &reader : readers_) {
+        S_.readers[variable_[reader.first]].push_back(reader.second);
+      }
+    }
+
+    // Build the successor rows from the terminators, then the predecessor
+    // rows from them by counting.
+    void FreezeCFG() {
+      uint32_t blocks = S_.blocks.size();
+      S_.succBegin.reserve(blocks + 1);
+      vector<uint32_t> predCount(blocks + 1, 0);
+      for(BasicBlock *BB : S_.blocks) {
+        S_.succBegin.push_back(S_.succs.size());
+        for(BasicBlock *succ : successors(BB)) {
+          uint32_t id = S_.blockIds[succ];
+          S_.succs.push_back(id);
+          predCount[id + 1]++;
+        }
+      }
+      S_.succBegin.push_back(S_.succs.size());
+      for(uint32_t b = 0; b < blocks; b++) {
+        predCount[b + 1] += predCount[b];
+      }
+      S_.predBegin = predCount;
+      S_.preds.resize(S_.succs.size());
+      for(uint32_t b = 0; b < blocks; b++) {
+        for(uint32_t succ : S_.SuccsOf(b)) {
+          S_.preds[predCount[succ]++] = b;
+        }
+      }
+    }
+
+    hyt::IRSummary &S_;
+    DenseMap<Value*, uint32_t> variable_; // Alloca => variable id.
+    DenseMap<Value*, uint32_t> pointer_;  // Pointer => index in pointers_.
+    vector<Value*> pointers_;             // Loaded and stored pointers, in order.
+    StringMap<uint32_t> expression_;      // Text => expression id.
+    vector<pair<AllocaInst*, uint32_t>> readers_; // <variable, expression reading it>
+  };
+}
+
+namespace hyt {
+  size_t IRSummary::HeapBytes() const {
+    return hyt::HeapBytes(blocks) + hyt::HeapBytes(blockIds) + hyt::HeapBytes(predBegin) +
+           hyt::HeapBytes(preds) + hyt::HeapBytes(succBegin) + hyt::HeapBytes(succs) +
+           hyt::HeapBytes(eventBegin) + hyt::HeapBytes(events) +
+           hyt::HeapBytes(locations) + hyt::HeapBytes(expressions) + hyt::HeapBytes(readers);
+  }
+
+  IRSummary Summarize(Function &F) {
+    TimeTraceScope trace("Summarize", F.getName());
+    IRSummary S;
+    Summarizer(S).Run(F);
+    return S;
+  }
+
+  AnalysisKey IRSummaryAnalysis::Key;
+
+  IRSummary IRSummaryAnalysis::run(Function &F, FunctionAnalysisManager &AM) {
+    return Summarize(F);
+  }
+
+  char IRSummaryWrapperPass::ID = 0;
+
+  bool IRSummaryWrapperPass::runOnFunction(Function &F) {
+    summary_ = Summarize(F);
+    return false;
+  }
+
+  void IRSummaryWrapperPass::getAnalysisUsage(AnalysisUsage &AU) const {
+    AU.setPreservesAll();
+  }
+
+  void IRSummaryWrapperPass::releaseMemory() {
+    summary_ = IRSummary();
+  }
+}
+
+static RegisterPass<hyt::IRSummaryWrapperPass> X("hytIRSummary", "Hyt IR Summary For Data Flow Analysis", false, true);
@@ -0,0 +1,123 @@
+//
+//
+// IR summary shared by the data flow analyses
+//
+// Summarize() walks the instructions of a function once, with an
+// InstVisitor, and keeps what Reaching Definition, Live Variables and
+// Available Expressions read of them, as events per block with dense ids:
+//   variables    the allocas of F, in order.
+//   locations    what loads and stores access: the variables first, then
+//                every other pointer in order of first access.
+//   expressions  the unary, binary, shift and logic operations by their
+//                text, e.g. " a add  b", in order of first appearance.
+// It also freezes the CFG into predecessor and successor arrays over the
+// block ids (compressed sparse rows), so the solvers iterate integers.
+// The analyses build their gen/kill and def/use sets from the summary and
+// do not walk the IR again.
+//
+// The summary is an analysis of its own, so a pipeline builds it once per
+// function: hytIRSummary for the legacy passes, which all preserve it, and
+// IRSummaryAnalysis for the new pass manager.
+//
+
+#ifndef HYT_SUMMARY_H
+#define HYT_SUMMARY_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/Pass.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace llvm {
+  class BasicBlock;
+  class Function;
+  class Instruction;
+  class Value;
+}
+
+namespace hyt {
+  struct IRSummary {
+    enum EventKind : uint8_t { Load, Store, Operation };
+
+    struct Event {
+      EventKind kind;
+      uint32_t id; // Location of a load or store, expression of an operation.
+      llvm::Instruction *inst;
+    };
+
+    // Block id => block, in the order of F, so the entry block is 0.
+    std::vector<llvm::BasicBlock*> blocks;
+    llvm::DenseMap<const llvm::BasicBlock*, uint32_t> blockIds;
+    // The predecessors of block b are preds[predBegin[b] .. predBegin[b + 1]),
+    // its successors succs[succBegin[b] .. succBegin[b + 1]). A block that
+    // branches to another twice is listed twice, as by predecessors() and
+    // successors().
+    std::vector<uint32_t> predBegin;
+    std::vector<uint32_t> preds;
+    std::vector<uint32_t> succBegin;
+    std::vector<uint32_t> succs;
+    // The events of block b are events[eventBegin[b] .. eventBegin[b + 1]).
+    std::vector<uint32_t> eventBegin;
+    std::vector<Event> events;
+
+    // Location id => pointer. Ids below `variables` are the allocas.
+    std::vector<llvm::Value*> locations;
+    uint32_t variables = 0;
+    uint32_t stores = 0;
+
+    // Expression id => text, without the trailing space of the AEA facts.
+    std::vector<std::string> expressions;
+    // Variable id => the expressions that read it, so a store to it kills
+    // them.
+    std::vector<std::vector<uint32_t>> readers;
+
+    llvm::ArrayRef<Event> EventsOf(uint32_t block) const {
+      return llvm::makeArrayRef(events.data() + eventBegin[block],
+                                events.data() + eventBegin[block + 1]);
+    }
+
+    llvm::ArrayRef<uint32_t> PredsOf(uint32_t block) const {
+      return llvm::makeArrayRef(preds.data() + predBegin[block],
+                                preds.data() + predBegin[block + 1]);
+    }
+
+    llvm::ArrayRef<uint32_t> SuccsOf(uint32_t block) const {
+      return llvm::makeArrayRef(succs.data() + succBegin[block],
+                                succs.data() + succBegin[block + 1]);
+    }
+
+    // Estimated heap bytes, for -hyt-mem-report.
+    size_t HeapBytes() const;
+  };
+
+  IRSummary Summarize(llvm::Function &F);
+
+  class IRSummaryAnalysis : public llvm::AnalysisInfoMixin<IRSummaryAnalysis> {
+    friend llvm::AnalysisInfoMixin<IRSummaryAnalysis>;
+    static llvm::AnalysisKey Key;
+
+  public:
+    using Result = IRSummary;
+    Result run(llvm::Function &F, llvm::FunctionAnalysisManager &AM);
+  };
+
+  struct IRSummaryWrapperPass : public llvm::FunctionPass {
+    static char ID;
+    IRSummaryWrapperPass() : llvm::FunctionPass(ID) {}
+
+    const IRSummary &Summary() const { return summary_; }
+
+    bool runOnFunction(llvm::Function &F) override;
+    void getAnalysisUsage(llvm::AnalysisUsage &AU) const override;
+    void releaseMemory() override;
+
+  private:
+    IRSummary summary_;
+  };
+}
+
+#endif
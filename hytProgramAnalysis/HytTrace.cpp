@@ -0,0 +1,68 @@
+//
+//
+// Chrome trace_event output shared by the passes, see HytTrace.h.
+//
+
+
+#include "HytTrace.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <atomic>
+#include <string>
+
+using namespace llvm;
+
+static cl::opt<std::string> TraceFile(
+    "hyt-time-trace", cl::value_desc("file"), cl::init(""),
+    cl::desc("Write the phases of the hyt passes to <file> as Chrome trace_event JSON"));
+
+static cl::opt<unsigned> TraceGranularity(
+    "hyt-time-trace-granularity", cl::value_desc("microseconds"), cl::init(500),
+    cl::desc("Leave spans shorter than <microseconds> out of -hyt-time-trace"));
+
+namespace {
+  // Passes between TimeTraceBegin() and TimeTraceEnd(), of all threads.
+  std::atomic<unsigned> activePasses(0);
+  // Whether the profiler was started by -hyt-time-trace, and so is ours to
+  // write and clean up.
+  bool ownsProfiler = false;
+}
+
+namespace hyt {
+  void TimeTraceBegin(StringRef passName) {
+    if(TraceFile.empty()) {
+      return;
+    }
+    if(activePasses++ == 0 && !timeTraceProfilerEnabled()) {
+      timeTraceProfilerInitialize(TraceGranularity, passName);
+      ownsProfiler = true;
+    }
+  }
+
+  void TimeTraceEnd() {
+    if(TraceFile.empty() || activePasses == 0 || --activePasses > 0 || !ownsProfiler) {
+      return;
+    }
+    ownsProfiler = false;
+    if(Error E = timeTraceProfilerWrite(TraceFile, "hyt")) {
+      errs() << "[ERROR] Cannot write time trace " << TraceFile << ": " << toString(std::move(E)) << "\n";
+    }
+    timeTraceProfilerCleanup();
+  }
+
+  TimeTraceThread::TimeTraceThread(bool enabled)
+    : owner_(enabled && !timeTraceProfilerEnabled()) {
+    if(owner_) {
+      timeTraceProfilerInitialize(TraceGranularity, "hyt worker");
+    }
+  }
+
+  TimeTraceThread::~TimeTraceThread() {
+    if(owner_) { // Hands the events of this thread over to the writer.
+      timeTraceProfilerFinishThread();
+    }
+  }
+}
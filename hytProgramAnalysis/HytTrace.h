@@ -0,0 +1,55 @@
+//
+//
+// Chrome trace_event output shared by the passes
+//
+// -hyt-time-trace=<file> records the phases of every pass in this plugin
+// with LLVM's time profiler and writes them to <file> as Chrome trace_event
+// JSON, which chrome://tracing and Perfetto load. The events are kept in
+// memory per thread and only written when the last pass has finished. Spans
+// shorter than -hyt-time-trace-granularity are left out of the timeline but
+// still count in its "Total <phase>" rows.
+//
+
+#ifndef HYT_TRACE_H
+#define HYT_TRACE_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Timer.h"
+
+namespace hyt {
+  // Start recording for a pass, from its doInitialization(). Does nothing
+  // without -hyt-time-trace, or when the profiler already runs, e.g. under
+  // opt -time-trace.
+  // A tool that runs the passes on several threads brackets them with a
+  // TimeTraceBegin()/TimeTraceEnd() of its own.
+  void TimeTraceBegin(llvm::StringRef passName);
+
+  // Stop recording for a pass, from its doFinalization(). The last pass
+  // writes the trace file.
+  void TimeTraceEnd();
+
+  // Lets a worker thread record into the trace while it lives. `enabled` is
+  // timeTraceProfilerEnabled() of the thread that handed out the work.
+  class TimeTraceThread {
+  public:
+    explicit TimeTraceThread(bool enabled);
+    ~TimeTraceThread();
+
+  private:
+    bool owner_;
+  };
+
+  // A -time-passes region that is also a span of the trace, named after its
+  // description.
+  struct Region {
+    Region(llvm::StringRef name, llvm::StringRef desc, llvm::StringRef group,
+           llvm::StringRef groupDesc, bool enabled)
+      : timer(name, desc, group, groupDesc, enabled), trace(desc) {}
+
+    llvm::NamedRegionTimer timer;
+    llvm::TimeTraceScope trace;
+  };
+}
+
+#endif
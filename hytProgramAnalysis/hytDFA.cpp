@@ -11,9 +11,25 @@
 #include "llvm/Pass.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
+
+#include "HytAnalysis.h"
+#include "HytMemory.h"
+#include "HytResults.h"
+#include "HytSummary.h"
+#include "HytTrace.h"
 
 #include <map>
 #include <string>
+#include <chrono>
 #include <stdint.h>
 
 using std::map;
@@ -25,7 +41,19 @@ using namespace llvm;
 
 
 #define DEBUG_TYPE "hytProgramAnalysis_ReachingDefinition"
-#define SHOW_INFO  //Show fact information and result. 
+
+STATISTIC(NumRounds, "Rounds over all blocks");
+STATISTIC(NumTransferCalls, "Transfer function calls");
+STATISTIC(NumMeets, "Meet operations");
+STATISTIC(NumBitVectorAllocs, "Bit vectors allocated");
+
+// Timer regions, shown by -time-passes.
+static const char *const TimerGroupName = "hytRD";
+static const char *const TimerGroupDesc = "Hyt Reaching Definition";
+
+static cl::opt<string> ReportFile(
+    "hyt-rd-report", cl::value_desc("file"), cl::init(""),
+    cl::desc("Append the solver statistics of each function to <file> as one JSON line"));
 
 namespace {
   // hytProgramAnalysis.
@@ -42,7 +70,8 @@ namespace {
     // Number of definition instruction.
     uint32_t def_count_ = 0;
     
-    // `fact_mask_` illustrate mapping form varables to their masks.
+    // `fact_mask_` illustrate mapping form varables to their masks, by the
+    // location ids of the IR summary of the current function.
     // A mask shows which definition instruction defines a specific varable.
     // e.g. d0: x = 1 + m;
     //      d1: y = 1;
@@ -52,40 +81,68 @@ namespace {
     // So, for varable x, its mask is 10100
     //     for varable y, its mask is 01010
     //     for varable z, its mask is 00001 
-    map<Instruction*, BitVector> fact_mask_;
+    std::vector<BitVector> fact_mask_;
     bool is_anyone_changed_ = false;
+    // Solver statistics of the last function, see WriteReport().
+    uint32_t round_ = 0;
+    uint64_t visits_ = 0;
+    double initSeconds_ = 0;
+    double solveSeconds_ = 0;
     
-    // gen and kill vevtor for each basic block.
-    map<BasicBlock*, BitVector> genB_;
-    map<BasicBlock*, BitVector> killB_;
+    // Blocks of the current function by their ids in the IR summary, and
+    // the other way round.
+    std::vector<BasicBlock*> blocks_;
+    DenseMap<const BasicBlock*, uint32_t> blockId_;
+
+    // gen and kill vevtor for each basic block, by block id.
+    std::vector<BitVector> genB_;
+    std::vector<BitVector> killB_;
 
     // map<BasicBlock*, BitVector> inB_;
-    map<BasicBlock*, BitVector> outB_;
+    std::vector<BitVector> outB_;
+
+    // Heap of each structure after the last function, and its high-water
+    // mark per function, see -hyt-mem-report.
+    hyt::HeapUsageList heap_;
+    hyt::MemoryLedger memory_;
 
-    void PrintFact(map<Instruction*, uint32_t> fact) {
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Fact => index:\n" ;
-      for(map<Instruction*, uint32_t>::iterator it = fact.begin();
+    void PrintFact(const map<Instruction*, uint32_t> &fact) {
+      hyt::ResultSink &results = hyt::Results();
+      if(results.WantsRecords(hyt::ResultsFull)) {
+        for(const pair<Instruction* const, uint32_t> &it : fact) {
+          string text;
+          raw_string_ostream OS(text);
+          OS << *it.first;
+          results.Label("fact", it.second, OS.str());
+        }
+        return;
+      }
+      raw_ostream &OS = results.Text(hyt::ResultsFull);
+      OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Fact => index:\n" ;
+      for(map<Instruction*, uint32_t>::const_iterator it = fact.begin();
           it != fact.end(); it++) {
-        errs() << *(it->first) << " => " << it->second << '\n';
+        OS << *(it->first) << " => " << it->second << '\n';
       }
     }
 
-    void PrintFactMask(map<Instruction*, BitVector> fact_mask) {
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Varable => Maks vector:\n" ;
-      for(map<Instruction*, BitVector>::iterator it = fact_mask.begin();
+    void PrintFactMask(const map<Instruction*, BitVector> &fact_mask) {
+      raw_ostream &OS = hyt::Results().Text(hyt::ResultsFull);
+      OS << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+         << " Varable => Maks vector:\n" ;
+      for(map<Instruction*, BitVector>::const_iterator it = fact_mask.begin();
           it != fact_mask.end(); it++) {
-        errs() << *(it->first) << " => ";
+        OS << *(it->first) << " => ";
         PrintBitVector(it->second);
       }
     }
     
-    void PrintBitVector(BitVector bit_vector) {
-      for(int i = 0; i < bit_vector.size(); i++) {
-        errs() << bit_vector[i] << " ";
+    void PrintBitVector(const BitVector &bit_vector) {
+      raw_ostream &OS = hyt::Results().Text(hyt::ResultsFull);
+      for(unsigned i = 0; i < bit_vector.size(); i++) {
+        OS << (bit_vector[i] ? "1 " : "0 ");
       }
-      errs() << "\n";
+      OS << "\n";
     }
 
     // @return true if this analysis is forward, otherwise false.
@@ -93,81 +150,85 @@ namespace {
       return true;
     }
 
-    bool InitGenAndMask(Function *F) {
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-             << " Start to init Gen and Fact Mask with " 
-             << def_count_ << " definitions\n";
+    // The stores of F are numbered in the order of the summary, from
+    // def_count_ - summary.stores on, see DoInit().
+    bool InitGenAndMask(const hyt::IRSummary &summary) {
+      TimeTraceScope trace("InitGenAndMask");
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                            << " Start to init Gen and Fact Mask with " 
+                            << def_count_ << " definitions\n";
+      uint32_t index = def_count_ - summary.stores;
+      fact_mask_.assign(summary.locations.size(), BitVector());
+      genB_.clear();
       BitVector tmp_genB;
-      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
+      for (uint32_t bb = 0; bb < summary.blocks.size(); bb++) {
         tmp_genB = BitVector(def_count_, false);  // Init zero vector for each block.
-        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-          string inst_opcode_name = inst->getOpcodeName ();
-          uint32_t index;
-          if (inst_opcode_name == "store") {
-            index = fact_[dyn_cast<Instruction>(inst)];
+        ++NumBitVectorAllocs;
+        for (const hyt::IRSummary::Event &event : summary.EventsOf(bb)) {
+          if (event.kind == hyt::IRSummary::Store) {
             tmp_genB[index] = true;
 
-            // The second operand of store instruction is the left value, 
-            // i.e., defined varable.
-            Instruction *varable = dyn_cast<Instruction>((inst->getOperand(1)));
-            if(fact_mask_.find(varable) == fact_mask_.end()) {
-              fact_mask_.insert(
-                pair<Instruction*, BitVector>(varable, BitVector(def_count_, false))
-              );
+            // The location a store defines.
+            BitVector &mask = fact_mask_[event.id];
+            if(mask.empty()) {
+              mask = BitVector(def_count_, false);
+              ++NumBitVectorAllocs;
             }
-            fact_mask_[varable][index] = true;
+            mask[index] = true;
+            index++;
           }
         }
-        genB_.insert(pair<BasicBlock*, BitVector>(dyn_cast<BasicBlock>(bb), tmp_genB));
+        genB_.push_back(tmp_genB);
       }
       return true;
     }
 
-    bool InitKill(Function *F) {
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-             <<" Start to init Kill with " 
-             << def_count_ << " definitions\n";
+    bool InitKill(const hyt::IRSummary &summary) {
+      TimeTraceScope trace("InitKill");
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                            <<" Start to init Kill with " 
+                            << def_count_ << " definitions\n";
+      killB_.clear();
       BitVector tmp_killB;
-      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
+      for (uint32_t bb = 0; bb < summary.blocks.size(); bb++) {
         tmp_killB = BitVector(def_count_, false);  // Init zero vector for each block.
-        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-          string inst_opcode_name = inst->getOpcodeName ();
-          uint32_t index;
-          if (inst_opcode_name == "store") {
-            // The second operand of store instruction is the left value, 
-            // i.e., defined varable.
-            Instruction *varable = dyn_cast<Instruction>((inst->getOperand(1)));
+        ++NumBitVectorAllocs;
+        for (const hyt::IRSummary::Event &event : summary.EventsOf(bb)) {
+          if (event.kind == hyt::IRSummary::Store) {
             // Union the related definition instruction bit
             // to the varable in current definition.
-            tmp_killB |= fact_mask_[varable];
+            tmp_killB |= fact_mask_[event.id];
           }
         }
-        killB_.insert(pair<BasicBlock*, BitVector>(dyn_cast<BasicBlock>(bb), tmp_killB));
+        killB_.push_back(tmp_killB);
       }
       return true;
     }
 
-    void DoInit(Function &F) {
-      Function *tmp = &F;
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-             <<" Start to find all definitions and get fact set\n";
-      for (Function::iterator bb = tmp->begin(); bb != tmp->end(); ++bb) {        
-        for (BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst) {
-            string inst_opcode_name = inst->getOpcodeName ();
-            if (inst_opcode_name == "store") {
-              fact_.insert(pair<Instruction*, uint32_t>(dyn_cast<Instruction>(inst), def_count_));
-              def_count_++;
-            }
+    void DoInit(Function &F, const hyt::IRSummary &summary) {
+      TimeTraceScope trace("DoInit");
+      hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                            <<" Start to find all definitions and get fact set\n";
+      Optional<hyt::Region> region;
+      region.emplace("init", "Number definitions", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      blocks_ = summary.blocks;
+      blockId_ = summary.blockIds;
+      for (const hyt::IRSummary::Event &event : summary.events) {
+        if (event.kind == hyt::IRSummary::Store) {
+          fact_.insert(pair<Instruction*, uint32_t>(event.inst, def_count_));
+          def_count_++;
         }
       }
-#ifdef SHOW_INFO
-      PrintFact(fact_);
-#endif
-      if(!InitGenAndMask(&F)) {
+      if(hyt::Results().Wants(hyt::ResultsFull)) {
+        region.emplace("print", "Print results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+        PrintFact(fact_);
+      }
+      region.emplace("genkill", "Build gen and kill sets", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      if(!InitGenAndMask(summary)) {
         errs() << "\033[31m" << "[ERROR] Initializing genB vector and varable mask failed!\n" << "\033[0m";
         exit(-1);
       }
-      if(!InitKill(&F)) {
+      if(!InitKill(summary)) {
         errs() << "\033[31m" << "[ERROR] Initializing killB vector failed!\n" << "\033[0m";
         exit(-1);
       }
@@ -181,6 +242,7 @@ namespace {
       }
       if(res.size() != a.size()) {
         res = BitVector(a.size(), false);
+        ++NumBitVectorAllocs;
       }
       for(size_t i = 0;i < a.size();i++) {
         // if and only if a[i] == true, b[i] == false, then a[i] - b[i] = 1
@@ -197,9 +259,10 @@ namespace {
     // @param in, current in vector IN[B]
     // @param out, current out vector OUT[B]
     void TransferFunction(
-        BasicBlock *bb, 
+        uint32_t bb, 
         BitVector &in,
         BitVector &out) {
+      ++NumTransferCalls;
       BitVector res;
       BitVectorSub(in, killB_[bb], res);
       res |= genB_[bb];
@@ -211,97 +274,232 @@ namespace {
 
     // res = a U b;
     void MeetInto(BitVector &a, BitVector &b, BitVector &res) {
+      ++NumMeets;
       if(a.size() != b.size()) {
         errs() << "\033[31m" << "[ERROR] MeetInto error -- Operands size are not equal!\n" << "\033[0m";
         exit(-1);
       }
       if(res.size() != a.size()) {
         res = BitVector(a.size(), false);
+        ++NumBitVectorAllocs;
       }
       BitVector tmp = a;
+      ++NumBitVectorAllocs;
       tmp |= b;
       res = tmp;
     }
 
-    // Forward analysis for reaching definition on function F
-    void ForwardAnalysis(Function *F) {
+    // Forward analysis for reaching definition on the blocks of the summary,
+    // over its predecessor arrays.
+    void ForwardAnalysis(const hyt::IRSummary &summary) {
+      TimeTraceScope trace("ForwardAnalysis");
       // Initializing OUT[entry] = empty;
       BitVector prev_out = BitVector(def_count_, false);
       // Traverse all basic block
       // For each block OUT[B] = empty;
-      for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
-        outB_.insert(
-            pair<BasicBlock*, BitVector>(
-                dyn_cast<BasicBlock>(bb), 
-                BitVector(def_count_, false)
-            )
-        );
-      }
+      uint32_t blocks = summary.blocks.size();
+      outB_.assign(blocks, BitVector(def_count_, false));
+      NumBitVectorAllocs += blocks + 1; // prev_out and one vector per block.
       
       // Do analysis if any out vector has changed.
-#ifdef SHOW_INFO
-      uint32_t round = 0; // Count travers round when do reaching difinition analysis.
-#endif 
+      round_ = 0; // Count travers round when do reaching difinition analysis.
+      visits_ = 0;
       do {
-#ifdef SHOW_INFO
         //errs() << round++ << "round";
-        round++;
-#endif
+        round_++;
+        ++NumRounds;
         is_anyone_changed_ = false;  // Initialize all things are not changed.
         // IN[B] = U (for all predecessor P of B) OUT[P]; 
         // Where IN[B] here is called prev_out;
-        for (Function::iterator bb = F->begin(); bb != F->end(); ++bb) {
-          BasicBlock *basic_block = dyn_cast<BasicBlock>(bb);
-          if (bb != F->begin()) { // Not entry, need to consider meet operation.
-            for (BasicBlock *pred : predecessors(basic_block)) {
+        for (uint32_t bb = 0; bb < blocks; bb++) {
+          if (bb != 0) { // Not entry, need to consider meet operation.
+            for (uint32_t pred : summary.PredsOf(bb)) {
               MeetInto(prev_out, outB_[pred], prev_out);
             }
           } 
           
           // OUT[B] = genB U (IN[B] - killB);
-          TransferFunction(basic_block, prev_out, outB_[basic_block]);
+          visits_++;
+          TransferFunction(bb, prev_out, outB_[bb]);
           prev_out.reset();
         }
       }while(is_anyone_changed_);
-#ifdef SHOW_INFO
-      errs() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
-             << " Total " << round << " round(s) analysis.\n";
-#endif
+      hyt::Results().Text() << "  [" << "\033[34m" << "*" << "\033[0m" << "]" 
+                            << " Total " << round_ << " round(s) analysis.\n";
     }
 
 
-    void DoDataFlowAnalysis(Function *F) {
+    void DoDataFlowAnalysis(const hyt::IRSummary &summary) {
       if(IsForward()) {
-        errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
-              <<" Start to do forward analysis.\n";
-        ForwardAnalysis(F);
+        hyt::Results().Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]" 
+                              <<" Start to do forward analysis.\n";
+        ForwardAnalysis(summary);
       } else {
         errs() << "[WARNING] Not supported now!\n";
       }
     }
 
-    bool runOnFunction(Function &F) override {
-      DoInit(F);
-      DoDataFlowAnalysis(&F);
-#ifdef SHOW_INFO
-      BasicBlock *basic_block;
-      for (Function::iterator bb = F.begin(); bb != F.end(); ++bb) {
-        basic_block = dyn_cast<BasicBlock>(bb);
-        errs() << "  ========================= \n";
-        errs() << "  For block: \n";
-        errs() << *basic_block << "\n";
-        errs() << "  Final OUT: ";
-        PrintBitVector(outB_[basic_block]);
-        errs() << "  ========================= \n";
+    // Append the solver statistics of F to -hyt-rd-report as one JSON line,
+    // so runs on different inputs or builds can be compared.
+    void WriteReport(Function &F) {
+      hyt::AppendReport(ReportFile, [&](json::OStream &J) {
+        J.attribute("analysis", "rd");
+        J.attribute("module", F.getParent()->getModuleIdentifier());
+        J.attribute("function", F.getName());
+        J.attribute("facts", (int64_t)def_count_);
+        J.attribute("blocks", (int64_t)F.size());
+        J.attribute("rounds", (int64_t)round_);
+        J.attribute("block_visits", (int64_t)visits_);
+        J.attribute("init_seconds", initSeconds_);
+        J.attribute("solve_seconds", solveSeconds_);
+      }, heap_);
+    }
+
+    // Estimated heap bytes of each structure.
+    hyt::HeapUsageList HeapUsage() {
+      return {
+        {"fact_", hyt::HeapBytes(fact_)},
+        {"fact_mask_", hyt::HeapBytes(fact_mask_)},
+        {"blockId_", hyt::HeapBytes(blockId_)},
+        {"genB_", hyt::HeapBytes(genB_)},
+        {"killB_", hyt::HeapBytes(killB_)},
+        {"outB_", hyt::HeapBytes(outB_)},
+      };
+    }
+
+    void getAnalysisUsage(AnalysisUsage &AU) const override {
+      AU.addRequired<hyt::IRSummaryWrapperPass>();
+      AU.setPreservesAll();
+    }
+
+    bool doInitialization(Module &M) override {
+      hyt::TimeTraceBegin("hytDFA_ReachingDefinition");
+      return false;
+    }
+
+    bool doFinalization(Module &M) override {
+      if(hyt::MemoryLedger::Enabled()) {
+        memory_.PrintTop("hytDFA_ReachingDefinition", errs());
+      }
+      hyt::Results().Flush();
+      hyt::TimeTraceEnd();
+      return false;
+    }
+
+    // Solve F and write -hyt-rd-report. The results are written by
+    // PrintResults(), so a new pass manager result can print them later.
+    void Solve(Function &F, const hyt::IRSummary &summary) {
+      hyt::ResultSink &results = hyt::Results();
+      results.Begin("rd", F.getName());
+      auto start = std::chrono::steady_clock::now();
+      DoInit(F, summary);
+      auto inited = std::chrono::steady_clock::now();
+      Optional<hyt::Region> region;
+      region.emplace("solve", "Solve", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      DoDataFlowAnalysis(summary);
+      region.reset();
+      if(hyt::MemoryLedger::Enabled()) { // The structures only grow while solving.
+        heap_ = HeapUsage();
+        for(pair<const char*, size_t> &usage : heap_) {
+          memory_.Sample(F.getName(), usage.first, usage.second);
+        }
+      }
+      initSeconds_ = std::chrono::duration<double>(inited - start).count();
+      solveSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - inited).count();
+      if(!ReportFile.empty()) {
+        WriteReport(F);
+      }
+    }
+
+    void PrintResults(Function &F) {
+      hyt::ResultSink &results = hyt::Results();
+      if(!results.InScope("rd", F.getName())) { // A cached result.
+        results.Begin("rd", F.getName());
       }
-#endif
-      errs() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
-             << " Finised\n";
+      Optional<hyt::Region> region;
+      if(results.Wants(hyt::ResultsFull)) {
+        region.emplace("print", "Print results", TimerGroupName, TimerGroupDesc, TimePassesIsEnabled);
+      }
+      if(results.WantsText(hyt::ResultsFull)) {
+        raw_ostream &OS = results.Text(hyt::ResultsFull);
+        for (uint32_t bb = 0; bb < blocks_.size(); bb++) {
+          OS << "  ========================= \n";
+          OS << "  For block: \n";
+          OS << *blocks_[bb] << "\n";
+          OS << "  Final OUT: ";
+          PrintBitVector(outB_[bb]);
+          OS << "  ========================= \n";
+        }
+      } else if(results.WantsRecords(hyt::ResultsFull)) { // Blocks by their position in F.
+        for (uint32_t bb = 0; bb < blocks_.size(); bb++) {
+          results.Label("block", bb, blocks_[bb]->getName());
+          results.Set("out", bb, outB_[bb]);
+        }
+      }
+      results.Count("facts", def_count_);
+      results.Count("blocks", F.size());
+      results.Count("rounds", round_);
+      results.End();
+      results.Text() << "[" << "\033[32m" << "+" << "\033[0m" << "]"
+                     << " Finised\n";
+    }
 
+    bool runOnFunction(Function &F) override {
+      TimeTraceScope trace("hytDFA_ReachingDefinition", F.getName());
+      Solve(F, getAnalysis<hyt::IRSummaryWrapperPass>().Summary());
+      PrintResults(F);
       return false;
     }
   };
 }
 
 char hytProgramAnalysis::ID = 0;
-static RegisterPass<hytProgramAnalysis> X("hytDFA_ReachingDefinition", "Hyt Program Analysis For Reaching Definition");
\ No newline at end of file
+static RegisterPass<hytProgramAnalysis> X("hytDFA_ReachingDefinition", "Hyt Program Analysis For Reaching Definition");
+
+// New pass manager, see HytAnalysis.h.
+namespace hyt {
+  AnalysisKey ReachingDefinitionAnalysis::Key;
+
+  ReachingDefinitions::ReachingDefinitions(std::unique_ptr<FunctionPass> solver) : solver_(std::move(solver)) {}
+  ReachingDefinitions::ReachingDefinitions(ReachingDefinitions &&) = default;
+  ReachingDefinitions::~ReachingDefinitions() = default;
+
+  const map<Instruction*, uint32_t> &ReachingDefinitions::Definitions() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->fact_;
+  }
+
+  const BitVector *ReachingDefinitions::Out(const BasicBlock *BB) const {
+    hytProgramAnalysis *solver = static_cast<hytProgramAnalysis*>(solver_.get());
+    DenseMap<const BasicBlock*, uint32_t>::const_iterator it = solver->blockId_.find(BB);
+    return it == solver->blockId_.end() ? nullptr : &solver->outB_[it->second];
+  }
+
+  uint32_t ReachingDefinitions::Rounds() const {
+    return static_cast<hytProgramAnalysis*>(solver_.get())->round_;
+  }
+
+  void ReachingDefinitions::Print(Function &F) const {
+    static_cast<hytProgramAnalysis*>(solver_.get())->PrintResults(F);
+  }
+
+  bool ReachingDefinitions::invalidate(Function &F, const PreservedAnalyses &PA,
+                                       FunctionAnalysisManager::Invalidator &Inv) {
+    PreservedAnalyses::PreservedAnalysisChecker PAC = PA.getChecker<ReachingDefinitionAnalysis>();
+    if(!PAC.preserved() && !PAC.preservedSet<AllAnalysesOn<Function>>()) {
+      return true;
+    }
+    return Inv.invalidate<IRSummaryAnalysis>(F, PA);
+  }
+
+  ReachingDefinitions ReachingDefinitionAnalysis::run(Function &F, FunctionAnalysisManager &AM) {
+    TimeTraceScope trace("hytDFA_ReachingDefinition", F.getName());
+    std::unique_ptr<hytProgramAnalysis> solver(new hytProgramAnalysis());
+    solver->Solve(F, AM.getResult<IRSummaryAnalysis>(F));
+    return ReachingDefinitions(std::move(solver));
+  }
+
+  PreservedAnalyses ReachingDefinitionPrinterPass::run(Function &F, FunctionAnalysisManager &AM) {
+    AM.getResult<ReachingDefinitionAnalysis>(F).Print(F);
+    return PreservedAnalyses::all();
+  }
+}
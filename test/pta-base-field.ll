@@ -0,0 +1,39 @@
+; A field stored through the base class layout and loaded through the layout
+; of the derived class is the same field node. Base has tail padding, so the
+; derived class embeds the packed %class.Base.base instead of %class.Base.
+;
+; RUN: opt -enable-new-pm=0 -load LLVMHytDFA.so -hytDFA_PointerAnalysis -disable-output %s 2>&1 | FileCheck %s
+;
+; CHECK: Pointer => class
+; CHECK: %o = alloca %class.Obj*, align 8 : [[OBJ:[0-9]+]]
+; CHECK: %r = alloca %class.Obj*, align 8 : [[OBJ]]
+
+%class.Obj = type { i32 }
+%class.Base = type <{ %class.Obj*, i32, [4 x i8] }>
+%class.Base.base = type <{ %class.Obj*, i32 }>
+%class.Derived = type <{ %class.Base.base, i32 }>
+
+define dso_local i32 @main() {
+entry:
+  %d = alloca %class.Derived*, align 8
+  %o = alloca %class.Obj*, align 8
+  %r = alloca %class.Obj*, align 8
+  %call = call noalias nonnull i8* @_Znwm(i64 16)
+  %0 = bitcast i8* %call to %class.Derived*
+  store %class.Derived* %0, %class.Derived** %d, align 8
+  %call1 = call noalias nonnull i8* @_Znwm(i64 4)
+  %1 = bitcast i8* %call1 to %class.Obj*
+  store %class.Obj* %1, %class.Obj** %o, align 8
+  %2 = load %class.Derived*, %class.Derived** %d, align 8
+  %3 = bitcast %class.Derived* %2 to %class.Base*
+  %f = getelementptr inbounds %class.Base, %class.Base* %3, i32 0, i32 0
+  %4 = load %class.Obj*, %class.Obj** %o, align 8
+  store %class.Obj* %4, %class.Obj** %f, align 8
+  %5 = load %class.Derived*, %class.Derived** %d, align 8
+  %g = getelementptr inbounds %class.Derived, %class.Derived* %5, i32 0, i32 0, i32 0
+  %6 = load %class.Obj*, %class.Obj** %g, align 8
+  store %class.Obj* %6, %class.Obj** %r, align 8
+  ret i32 0
+}
+
+declare dso_local nonnull i8* @_Znwm(i64)
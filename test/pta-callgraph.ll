@@ -0,0 +1,90 @@
+; The virtual call in main is resolved to B::foo, and a later pass reads it
+; from hyt::PointsTo::CallGraph() as an llvm::CallGraph.
+;
+; RUN: opt -load LLVMHytDFA.so -load-pass-plugin LLVMHytDFA.so -passes='print<hyt-pta-callgraph>' -disable-output %s 2>&1 | FileCheck %s
+;
+; CHECK-LABEL: Call graph node for function: 'main'
+; CHECK: calls function '_ZN1BC2Ev'
+; CHECK: calls function '_ZN1B3fooEv'
+; CHECK-NOT: calls external node
+
+%class.A = type { i32 (...)** }
+%class.B = type { %class.A }
+
+@_ZTV1B = linkonce_odr dso_local unnamed_addr constant { [3 x i8*] } { [3 x i8*] [i8* null, i8* bitcast ({ i8*, i8*, i8* }* @_ZTI1B to i8*), i8* bitcast (void (%class.B*)* @_ZN1B3fooEv to i8*)] }, align 8
+@_ZTV1A = linkonce_odr dso_local unnamed_addr constant { [3 x i8*] } { [3 x i8*] [i8* null, i8* bitcast ({ i8*, i8* }* @_ZTI1A to i8*), i8* bitcast (void (%class.A*)* @_ZN1A3fooEv to i8*)] }, align 8
+@_ZTVN10__cxxabiv117__class_type_infoE = external dso_local global i8*
+@_ZTS1A = linkonce_odr dso_local constant [3 x i8] c"1A\00", align 1
+@_ZTI1A = linkonce_odr dso_local constant { i8*, i8* } { i8* bitcast (i8** getelementptr inbounds (i8*, i8** @_ZTVN10__cxxabiv117__class_type_infoE, i64 2) to i8*), i8* getelementptr inbounds ([3 x i8], [3 x i8]* @_ZTS1A, i32 0, i32 0) }, align 8
+@_ZTVN10__cxxabiv120__si_class_type_infoE = external dso_local global i8*
+@_ZTS1B = linkonce_odr dso_local constant [3 x i8] c"1B\00", align 1
+@_ZTI1B = linkonce_odr dso_local constant { i8*, i8*, i8* } { i8* bitcast (i8** getelementptr inbounds (i8*, i8** @_ZTVN10__cxxabiv120__si_class_type_infoE, i64 2) to i8*), i8* getelementptr inbounds ([3 x i8], [3 x i8]* @_ZTS1B, i32 0, i32 0), i8* bitcast ({ i8*, i8* }* @_ZTI1A to i8*) }, align 8
+
+define dso_local i32 @main() {
+entry:
+  %retval = alloca i32, align 4
+  %a = alloca %class.A*, align 8
+  %c = alloca %class.A*, align 8
+  %b = alloca %class.A*, align 8
+  store i32 0, i32* %retval, align 4
+  %call = call noalias nonnull i8* @_Znwm(i64 8)
+  %0 = bitcast i8* %call to %class.B*
+  call void @_ZN1BC2Ev(%class.B* nonnull align 8 dereferenceable(8) %0)
+  %1 = bitcast %class.B* %0 to %class.A*
+  store %class.A* %1, %class.A** %a, align 8
+  %callx = call noalias nonnull i8* @_Znwm(i64 8) 
+  %bx = bitcast i8* %callx to %class.B*
+  call void @_ZN1BC2Ev(%class.B* nonnull dereferenceable(8) %bx)
+  %ax = bitcast %class.B* %bx to %class.A*
+  store %class.A* %ax, %class.A** %c, align 8
+  %lx = load %class.A*, %class.A** %c, align 8
+  %2 = load %class.A*, %class.A** %a, align 8
+  store %class.A* %2, %class.A** %b, align 8
+  %3 = load %class.A*, %class.A** %a, align 8
+  %4 = bitcast %class.A* %3 to void (%class.A*)***
+  %vtable = load void (%class.A*)**, void (%class.A*)*** %4, align 8
+  %vfn = getelementptr inbounds void (%class.A*)*, void (%class.A*)** %vtable, i64 0
+  %5 = load void (%class.A*)*, void (%class.A*)** %vfn, align 8
+  call void %5(%class.A* nonnull align 8 dereferenceable(8) %3)
+  ret i32 0
+}
+
+declare dso_local nonnull i8* @_Znwm(i64)
+
+define linkonce_odr dso_local void @_ZN1BC2Ev(%class.B* nonnull align 8 dereferenceable(8) %this) unnamed_addr align 2 {
+entry:
+  %this.addr = alloca %class.B*, align 8
+  store %class.B* %this, %class.B** %this.addr, align 8
+  %this1 = load %class.B*, %class.B** %this.addr, align 8
+  %0 = bitcast %class.B* %this1 to %class.A*
+  call void @_ZN1AC2Ev(%class.A* nonnull align 8 dereferenceable(8) %0)
+  %1 = bitcast %class.B* %this1 to i32 (...)***
+  store i32 (...)** bitcast (i8** getelementptr inbounds ({ [3 x i8*] }, { [3 x i8*] }* @_ZTV1B, i32 0, inrange i32 0, i32 2) to i32 (...)**), i32 (...)*** %1, align 8
+  ret void
+}
+
+define linkonce_odr dso_local void @_ZN1AC2Ev(%class.A* nonnull align 8 dereferenceable(8) %this) unnamed_addr align 2 {
+entry:
+  %this.addr = alloca %class.A*, align 8
+  store %class.A* %this, %class.A** %this.addr, align 8
+  %this1 = load %class.A*, %class.A** %this.addr, align 8
+  %0 = bitcast %class.A* %this1 to i32 (...)***
+  store i32 (...)** bitcast (i8** getelementptr inbounds ({ [3 x i8*] }, { [3 x i8*] }* @_ZTV1A, i32 0, inrange i32 0, i32 2) to i32 (...)**), i32 (...)*** %0, align 8
+  ret void
+}
+
+define linkonce_odr dso_local void @_ZN1B3fooEv(%class.B* nonnull align 8 dereferenceable(8) %this) unnamed_addr align 2 {
+entry:
+  %this.addr = alloca %class.B*, align 8
+  store %class.B* %this, %class.B** %this.addr, align 8
+  %this1 = load %class.B*, %class.B** %this.addr, align 8
+  ret void
+}
+
+define linkonce_odr dso_local void @_ZN1A3fooEv(%class.A* nonnull align 8 dereferenceable(8) %this) unnamed_addr align 2 {
+entry:
+  %this.addr = alloca %class.A*, align 8
+  store %class.A* %this, %class.A** %this.addr, align 8
+  %this1 = load %class.A*, %class.A** %this.addr, align 8
+  ret void
+}
@@ -0,0 +1,30 @@
+; Two calls of a factory may return the same object, so the variables that
+; hold their results are not complete and their loads may alias.
+;
+; RUN: opt -enable-new-pm=0 -load LLVMHytDFA.so -hytDFA_PointerAnalysis -hytPTA-aa -aa-eval -print-all-alias-modref-info -disable-output %s 2>&1 | FileCheck %s
+;
+; CHECK: MayAlias: %class.T* %a, %class.T* %b
+; CHECK: MayAlias: i32* %fa, i32* %fb
+
+%class.T = type { i32 }
+
+define dso_local i32 @main() {
+entry:
+  %x = alloca %class.T*, align 8
+  %y = alloca %class.T*, align 8
+  %call = call i8* @getInstance()
+  %0 = bitcast i8* %call to %class.T*
+  store %class.T* %0, %class.T** %x, align 8
+  %call1 = call i8* @getInstance()
+  %1 = bitcast i8* %call1 to %class.T*
+  store %class.T* %1, %class.T** %y, align 8
+  %a = load %class.T*, %class.T** %x, align 8
+  %b = load %class.T*, %class.T** %y, align 8
+  %fa = getelementptr inbounds %class.T, %class.T* %a, i32 0, i32 0
+  %fb = getelementptr inbounds %class.T, %class.T* %b, i32 0, i32 0
+  store i32 1, i32* %fa, align 4
+  store i32 2, i32* %fb, align 4
+  ret i32 0
+}
+
+declare dso_local i8* @getInstance()